@@ -0,0 +1,310 @@
+/**
+ * @brief It implements the autosave of the game in the background
+ *
+ * When the interval has passed and the state has changed, the process
+ * forks. The child has a copy of the game frozen at that moment, as the
+ * kernel only copies the pages the parent writes afterwards, so it saves
+ * it at its own pace and exits, while the game goes on at once. The
+ * child sends how long it took and how big the snapshot is through a
+ * pipe, and it is reaped on a later tick.
+ *
+ * The snapshots are <prefix>.0 to <prefix>.<retention - 1>, used in
+ * turns, so only the last ones are kept.
+ *
+ * @file autosave.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "autosave.h"
+
+/**
+ * @brief What the child tells the parent
+ */
+typedef struct _Autosave_report
+{
+  double ms; /*!< Time it took to write the snapshot */
+  long size; /*!< Bytes of the snapshot, negative if it failed */
+} Autosave_report;
+
+/**
+ * @brief The structure of the autosave
+ *
+ * It stores the settings, the child writing a snapshot if there is
+ * one, and the metrics
+ */
+struct _Autosave
+{
+  char prefix[WORD_SIZE];  /*!< Start of the name of the snapshots */
+  long interval_ms;        /*!< Time between two autosaves */
+  int retention;           /*!< Number of snapshots kept */
+  unsigned long seq;       /*!< Number of autosaves started */
+  struct timespec last;    /*!< When the last autosave started */
+  unsigned long hash;      /*!< Hash of the state saved last */
+  T_Command last_cmd;      /*!< Last command of the state saved last */
+  pid_t child;             /*!< Child writing a snapshot, or -1 */
+  int report;              /*!< Pipe to read the report of the child */
+  Autosave_stats stats;    /*!< Metrics */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+void autosave_reap(Autosave *autosave, BOOL wait);
+void autosave_child(Game *game, const char *path, int report);
+double autosave_ms_between(const struct timespec *from, const struct timespec *to);
+
+/**
+* @brief Computes the creation of the autosave
+*
+* autosave_create creates an autosave, the first snapshot is taken
+* after the first interval
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param prefix is the start of the name of the snapshots
+* @param interval_ms is the time between two autosaves
+* @param retention is the number of snapshots kept
+* @return the new autosave or NULL if the arguments are not valid
+*/
+Autosave *autosave_create(const char *prefix, long interval_ms, int retention)
+{
+  Autosave *autosave = NULL;
+
+  if (!prefix || strlen(prefix) >= WORD_SIZE || interval_ms < 0 || retention < 1)
+    return NULL;
+
+  if (!(autosave = (Autosave *)calloc(1, sizeof(Autosave))))
+    return NULL;
+
+  strcpy(autosave->prefix, prefix);
+  autosave->interval_ms = interval_ms;
+  autosave->retention = retention;
+  autosave->last_cmd = NO_CMD;
+  autosave->child = -1;
+  autosave->report = -1;
+  clock_gettime(CLOCK_MONOTONIC, &autosave->last);
+
+  return autosave;
+}
+
+/**
+* @brief Computes the destruction of the autosave
+*
+* autosave_destroy waits for the snapshot being written, if any,
+* and frees the autosave
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param autosave is the autosave
+*/
+void autosave_destroy(Autosave *autosave)
+{
+  if (!autosave)
+    return;
+
+  autosave_reap(autosave, TRUE);
+  free(autosave);
+}
+
+/**
+* @brief Starts an autosave if it is time
+*
+* autosave_tick is called from the thread that changes the game. It
+* reaps the last child if it has finished, and forks a new one when the
+* interval has passed, the last one has finished and the state has
+* changed since the last snapshot
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param autosave is the autosave
+* @param game is the game
+* @return ERROR if a fork was needed and failed
+*/
+STATUS autosave_tick(Autosave *autosave, Game *game)
+{
+  struct timespec now, forked;
+  char path[WORD_SIZE + 24];
+  int fds[2];
+  pid_t pid = 0;
+  double us = 0;
+
+  if (!autosave || !game)
+    return ERROR;
+
+  if (autosave->child != -1)
+  {
+    autosave_reap(autosave, FALSE);
+    if (autosave->child != -1)
+      return OK; /* Still writing */
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (autosave_ms_between(&autosave->last, &now) < autosave->interval_ms)
+    return OK;
+  autosave->last = now;
+
+  if (autosave->seq > 0 && autosave->hash == game_get_hash(game) &&
+      autosave->last_cmd == game_get_last_command(game))
+    return OK; /* Nothing new to save */
+
+  sprintf(path, "%s.%lu", autosave->prefix, autosave->seq % autosave->retention);
+  if (pipe(fds) == -1)
+    return ERROR;
+
+  if ((pid = fork()) == -1)
+  {
+    close(fds[0]);
+    close(fds[1]);
+    return ERROR;
+  }
+  if (pid == 0)
+  {
+    close(fds[0]);
+    autosave_child(game, path, fds[1]); /* It does not return */
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &forked);
+  close(fds[1]);
+  autosave->child = pid;
+  autosave->report = fds[0];
+  autosave->seq++;
+  autosave->hash = game_get_hash(game);
+  autosave->last_cmd = game_get_last_command(game);
+
+  us = autosave_ms_between(&now, &forked) * 1000;
+  autosave->stats.fork_us = us;
+  if (us > autosave->stats.max_fork_us)
+    autosave->stats.max_fork_us = us;
+
+  return OK;
+}
+
+/**
+* @brief Gets the metrics
+*
+* autosave_get_stats copies the metrics of the autosaves finished
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param autosave is the autosave
+* @param stats is where the metrics are copied
+*/
+void autosave_get_stats(Autosave *autosave, Autosave_stats *stats)
+{
+  if (!autosave || !stats)
+    return;
+
+  *stats = autosave->stats;
+}
+
+/**
+* @brief Reaps the child
+*
+* autosave_reap collects the report of the child if it has finished,
+* or waits for it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param autosave is the autosave
+* @param wait is TRUE to wait for the child to finish
+*/
+void autosave_reap(Autosave *autosave, BOOL wait)
+{
+  Autosave_report report;
+  pid_t pid = 0;
+  int status = 0;
+
+  if (autosave->child == -1)
+    return;
+
+  while ((pid = waitpid(autosave->child, &status, wait ? 0 : WNOHANG)) == -1 && errno == EINTR)
+    ;
+  if (pid == 0)
+    return;
+
+  /* The child wrote its report before exiting */
+  if (pid == autosave->child && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+      read(autosave->report, &report, sizeof(report)) == sizeof(report) && report.size >= 0)
+  {
+    autosave->stats.saves++;
+    autosave->stats.last_ms = report.ms;
+    autosave->stats.last_size = report.size;
+    if (report.ms > autosave->stats.max_ms)
+      autosave->stats.max_ms = report.ms;
+  }
+  else
+  {
+    autosave->stats.failures++;
+  }
+
+  close(autosave->report);
+  autosave->report = -1;
+  autosave->child = -1;
+}
+
+/**
+* @brief Writes the snapshot in the child
+*
+* autosave_child saves the game, sends the report and exits without
+* running anything of the parent, like its exit handlers or buffers
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the copy of the game of the child
+* @param path is the file of the snapshot
+* @param report is the pipe to the parent
+*/
+void autosave_child(Game *game, const char *path, int report)
+{
+  Autosave_report result;
+  struct timespec start, end;
+  struct stat st;
+  ssize_t n = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  result.size = -1;
+  if (game_save(game, path) == OK && stat(path, &st) == 0)
+    result.size = (long)st.st_size;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  result.ms = autosave_ms_between(&start, &end);
+
+  while ((n = write(report, &result, sizeof(result))) == -1 && errno == EINTR)
+    ;
+  _exit((n == sizeof(result) && result.size >= 0) ? 0 : 1);
+}
+
+/**
+* @brief Measures a time
+*
+* autosave_ms_between gets the milliseconds between two times
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param from is the first time
+* @param to is the second time
+* @return the milliseconds
+*/
+double autosave_ms_between(const struct timespec *from, const struct timespec *to)
+{
+  return (to->tv_sec - from->tv_sec) * 1e3 + (to->tv_nsec - from->tv_nsec) / 1e6;
+}
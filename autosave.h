@@ -0,0 +1,40 @@
+/**
+ * @brief It defines the autosave of the game in the background
+ *
+ * @file autosave.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include "types.h"
+#include "game.h"
+
+#define AUTOSAVE_INTERVAL_MS 60000 /* Default time between two autosaves */
+#define AUTOSAVE_RETENTION 3       /* Default number of snapshots kept */
+
+typedef struct _Autosave Autosave;
+
+/**
+ * @brief The metrics of the autosaves
+ */
+typedef struct _Autosave_stats
+{
+  unsigned long saves;    /*!< Snapshots written */
+  unsigned long failures; /*!< Snapshots that could not be written */
+  double last_ms;         /*!< Time the last snapshot took to be written */
+  double max_ms;          /*!< Longest time a snapshot took to be written */
+  long last_size;         /*!< Bytes of the last snapshot */
+  double fork_us;         /*!< Time the game was stopped by the last fork */
+  double max_fork_us;     /*!< Longest time the game was stopped by a fork */
+} Autosave_stats;
+
+Autosave *autosave_create(const char *prefix, long interval_ms, int retention);
+void autosave_destroy(Autosave *autosave);
+STATUS autosave_tick(Autosave *autosave, Game *game);
+void autosave_get_stats(Autosave *autosave, Autosave_stats *stats);
+
+#endif
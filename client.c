@@ -0,0 +1,317 @@
+/**
+ * @brief It plays a game served by oca-server over the binary protocol
+ *
+ * The client sends the commands of its input to a delta listener of
+ * the server as they are, and gets back what changed in the state of
+ * the game after them. It paints every frame itself, with its own
+ * graphic engine on its own copy of the world, which must be the one
+ * the server plays on. So only a few bytes travel for every frame
+ * instead of the whole painted screen.
+ *
+ * With --quiet nothing is painted, to measure the traffic.
+ *
+ * @file client.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "game.h"
+#include "graphic_engine.h"
+#include "delta.h"
+
+#define CLIENT_READ_SIZE 4096 /* Bytes read at once */
+
+/**
+ * @brief The client
+ */
+typedef struct _Client
+{
+  int fd;                     /*!< Socket of the server */
+  Game game;                  /*!< Game on the copy of the world, only used to paint */
+  Game_state state;           /*!< State of the game in the server */
+  Graphic_engine *gengine;    /*!< Paints the frames */
+  Graphic_feedback feedback;  /*!< Commands shown in the feedback area */
+  unsigned long fingerprint;  /*!< Fingerprint of the world in the server */
+  BOOL greeted;               /*!< Whether the hello has been received */
+  BOOL quiet;                 /*!< Whether the frames are not painted */
+  unsigned char buf[CLIENT_READ_SIZE + DELTA_MESSAGE_MAX]; /*!< Bytes received and not decoded yet */
+  size_t len;                 /*!< Number of bytes in the buffer */
+  unsigned long updates;      /*!< Messages received */
+  unsigned long bytes;        /*!< Bytes received */
+} Client;
+
+int client_connect_tcp(int port);
+int client_connect_unix(const char *path);
+STATUS client_receive(Client *client);
+STATUS client_send(int fd, const char *buf, size_t len);
+
+int main(int argc, char *argv[])
+{
+  Client client;
+  struct pollfd fds[2];
+  char input[CLIENT_READ_SIZE];
+  char *unix_path = NULL;
+  unsigned long hits = 0, misses = 0;
+  ssize_t n = 0;
+  int port = -1, i = 0, n_fds = 2;
+  STATUS status = OK;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "Use: %s <game_data_file> (--port <port> | --unix <path>) [--quiet]\n", argv[0]);
+    return 1;
+  }
+
+  memset(&client, 0, sizeof(client));
+  for (i = 2; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--port") && i + 1 < argc)
+      port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--unix") && i + 1 < argc)
+      unix_path = argv[++i];
+    else if (!strcmp(argv[i], "--quiet"))
+      client.quiet = TRUE;
+    else
+    {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+  if (port < 0 && !unix_path)
+  {
+    fprintf(stderr, "The server is missing, give --port or --unix.\n");
+    return 1;
+  }
+
+  if (game_create_from_file(&client.game, argv[1]) == ERROR)
+  {
+    fprintf(stderr, "Error while initializing game.\n");
+    game_destroy(&client.game);
+    return 1;
+  }
+  if (!(client.gengine = graphic_engine_create()))
+  {
+    fprintf(stderr, "Error while initializing graphic engine.\n");
+    game_destroy(&client.game);
+    return 1;
+  }
+  graphic_feedback_init(&client.feedback);
+  /* Anything but the fingerprint of the world, until the hello says it */
+  client.fingerprint = ~game_world_fingerprint(&client.game);
+
+  if ((client.fd = unix_path ? client_connect_unix(unix_path) : client_connect_tcp(port)) == -1)
+  {
+    fprintf(stderr, "Error while connecting: %s.\n", strerror(errno));
+    graphic_engine_destroy(client.gengine);
+    game_destroy(&client.game);
+    return 1;
+  }
+
+  fds[0].fd = client.fd;
+  fds[0].events = POLLIN;
+  fds[1].fd = STDIN_FILENO;
+  fds[1].events = POLLIN;
+  while (status == OK)
+  {
+    if (poll(fds, n_fds, -1) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    if (fds[0].revents)
+    {
+      status = client_receive(&client);
+      continue;
+    }
+    if (n_fds == 2 && fds[1].revents)
+    {
+      if ((n = read(STDIN_FILENO, input, sizeof(input))) == -1 && errno == EINTR)
+        continue;
+      if (n > 0)
+      {
+        status = client_send(client.fd, input, n);
+        continue;
+      }
+      /* The server applies what it has and closes */
+      shutdown(client.fd, SHUT_WR);
+      n_fds = 1;
+    }
+  }
+
+  fprintf(stderr, "Updates: %lu, bytes received: %lu, %.1f bytes per update\n", client.updates, client.bytes,
+          client.updates ? (double)client.bytes / client.updates : 0.0);
+  graphic_engine_get_cache_stats(client.gengine, &hits, &misses);
+  fprintf(stderr, "Frame cache: %lu hits, %lu misses\n", hits, misses);
+
+  close(client.fd);
+  graphic_engine_destroy(client.gengine);
+  game_destroy(&client.game);
+
+  return client.greeted ? 0 : 1;
+}
+
+/**
+* @brief Connects to the server over TCP
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param port is the port of the server on localhost
+* @return the socket, or -1 if it could not connect
+*/
+int client_connect_tcp(int port)
+{
+  struct sockaddr_in addr;
+  int fd = -1;
+
+  if ((fd = socket(AF_INET, SOCK_STREAM, 0)) == -1)
+    return -1;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((unsigned short)port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+  {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+/**
+* @brief Connects to the server over a Unix socket
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param path is the path of the socket
+* @return the socket, or -1 if it could not connect
+*/
+int client_connect_unix(const char *path)
+{
+  struct sockaddr_un addr;
+  int fd = -1;
+
+  if (strlen(path) >= sizeof(addr.sun_path))
+  {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+    return -1;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+  {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+/**
+* @brief Receives the changes of the game
+*
+* client_receive reads what the server sent, and paints a frame for
+* every message received whole
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param client is the client
+* @return ERROR when the server has closed or sent something wrong
+*/
+STATUS client_receive(Client *client)
+{
+  const char *frame = NULL;
+  size_t at = 0, len = 0;
+  ssize_t n = 0;
+  long message = 0;
+
+  while ((n = read(client->fd, client->buf + client->len, CLIENT_READ_SIZE)) == -1 && errno == EINTR)
+    ;
+  if (n <= 0)
+    return ERROR;
+  client->len += n;
+  client->bytes += n;
+
+  while ((message = delta_decode(client->buf + at, client->len - at, &client->state, &client->fingerprint)) > 0)
+  {
+    at += message;
+    if (!client->greeted && client->fingerprint != game_world_fingerprint(&client->game))
+    {
+      fprintf(stderr, "The server plays on another world.\n");
+      return ERROR;
+    }
+    client->greeted = TRUE;
+    client->updates++;
+
+    if (!client->quiet &&
+        (frame = graphic_engine_render_state(client->gengine, &client->game, &client->state, &client->feedback, &len)))
+    {
+      fwrite(frame, 1, len, stdout);
+      fflush(stdout);
+    }
+  }
+  if (message < 0)
+  {
+    fprintf(stderr, "The server sent a message that is not valid.\n");
+    return ERROR;
+  }
+
+  /* What is left is the start of a message, shorter than DELTA_MESSAGE_MAX */
+  memmove(client->buf, client->buf + at, client->len - at);
+  client->len -= at;
+  return OK;
+}
+
+/**
+* @brief Sends bytes to the server
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fd is the socket
+* @param buf is the bytes
+* @param len is the number of bytes
+* @return the status
+*/
+STATUS client_send(int fd, const char *buf, size_t len)
+{
+  ssize_t n = 0;
+
+  while (len > 0)
+  {
+    if ((n = write(fd, buf, len)) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      return ERROR;
+    }
+    buf += n;
+    len -= n;
+  }
+
+  return OK;
+}
@@ -1,53 +1,349 @@
-/** 
- * @brief It implements the command interpreter
- * 
- * @file command.c
- * @author David Ramirez
- * @version 1.1 
- * @date 18/02/2019 
- */
-
-#include <stdio.h>
-#include <strings.h>
-#include "command.h"
-
-#define CMD_LENGHT 30
-#define N_CMD 7
-
-char *cmd_to_str[N_CMD] = {"No command", "Unknown", "Exit", "Next", "Back", "Take", "Drop"};
-char *short_cmd_to_str[N_CMD] = {"", "", "e", "n", "b", "t", "d"};
-
-/**
-* @brief Takes the parameters written with the keyboard
-*
-* get_user_input gets the input written with the keyboard to know what it has to do.
-* The possibilities are "No command", "Unknown", "Exit", "Next", "Back", "Take", "Drop"
-*
-* @date 18/02/2019
-* @author David Ramirez
-*
-* @return the parameter written with the keyboard
-*/
-T_Command get_user_input()
-{
-	T_Command cmd = NO_CMD;
-	char input[CMD_LENGHT] = "";
-	int i = UNKNOWN - NO_CMD + 1;
-
-	if (scanf("%s", input) > 0)
-	{
-		cmd = UNKNOWN;
-		while (cmd == UNKNOWN && i < N_CMD)
-		{
-			if (!strcasecmp(input, short_cmd_to_str[i]) || !strcasecmp(input, cmd_to_str[i]))
-			{
-				cmd = i + NO_CMD;
-			}
-			else
-			{
-				i++;
-			}
-		}
-	}
-	return cmd;
-}
+/** 
+ * @brief It implements the command interpreter
+ *
+ * The input is read in large chunks and split in lines, one command per
+ * line: a keyword and an optional argument. Keywords are looked up in a
+ * perfect hash table generated at build time from command.def, so a line
+ * is parsed in a single pass over its characters. In raw mode there are
+ * no lines: every key is looked up as a short name and is a command.
+ * 
+ * @file command.c
+ * @author David Ramirez
+ * @version 1.2 
+ * @date 19/10/2026 
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <unistd.h>
+#include "command.h"
+#include "command_keyword.h"
+
+#define N_CMD (N_COMMANDS + 1)
+#define READER_SIZE 65536
+#define KEY_INTERRUPT 3 /* Ctrl-C, not a signal in raw mode */
+#define KEY_END 4       /* Ctrl-D */
+
+/**
+ * @brief An entry of the keyword table
+ */
+typedef struct _Command_keyword
+{
+  const char *word; /*!< Keyword in lower case, NULL if the slot is free */
+  size_t len;       /*!< Length of the keyword */
+  T_Command cmd;    /*!< Command of the keyword */
+} Command_keyword;
+
+#include "command_hash.h"
+
+const char *const cmd_to_str[N_CMD] = {"No command",
+#define CMD(id, name, short_name) name,
+#include "command.def"
+#undef CMD
+};
+
+/**
+ * @brief The structure of the command reader
+ *
+ * It stores the descriptor it reads from and the chunk
+ * of input not parsed yet
+ */
+struct _Command_reader
+{
+  int fd;                 /*!< Descriptor of the input */
+  char buf[READER_SIZE];  /*!< Input read and not parsed yet */
+  size_t pos, len;        /*!< First byte not parsed and bytes in the buffer */
+  BOOL eof;               /*!< Whether the input has ended */
+  BOOL raw;               /*!< Whether every key is a command */
+  BOOL discarding;        /*!< Whether a line too long is skipped up to its end */
+};
+
+/**
+* @brief Computes the creation of a command reader
+*
+* command_reader_create creates a reader of commands from a descriptor
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fd is the descriptor of the input
+* @return the new reader or NULL if there is no memory
+*/
+Command_reader *command_reader_create(int fd)
+{
+  Command_reader *reader = NULL;
+
+  if (!(reader = (Command_reader *)malloc(sizeof(Command_reader))))
+    return NULL;
+
+  reader->fd = fd;
+  reader->pos = reader->len = 0;
+  reader->eof = FALSE;
+  reader->raw = FALSE;
+  reader->discarding = FALSE;
+
+  return reader;
+}
+
+/**
+* @brief Computes the destruction of a command reader
+*
+* command_reader_destroy frees the reader, but does not close its descriptor
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param reader is the reader which is going to be destroyed
+*/
+void command_reader_destroy(Command_reader *reader)
+{
+  free(reader);
+}
+
+/**
+* @brief Sets the mode of a command reader
+*
+* command_reader_set_raw chooses between one command per line and
+* one command per key
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param reader is the reader
+* @param raw is TRUE to read one command per key
+* @return the status
+*/
+STATUS command_reader_set_raw(Command_reader *reader, BOOL raw)
+{
+  if (!reader)
+    return ERROR;
+
+  reader->raw = raw;
+  return OK;
+}
+
+/**
+* @brief Checks if a command is already buffered
+*
+* command_reader_pending tells whether the next call to
+* command_reader_next can return without reading, so the caller
+* only has to wait for the descriptor when it is FALSE
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param reader is the reader
+* @return TRUE if there is input left to parse
+*/
+BOOL command_reader_pending(Command_reader *reader)
+{
+  if (!reader)
+    return FALSE;
+
+  if (reader->eof || (reader->raw && reader->pos < reader->len))
+    return TRUE;
+
+  return memchr(reader->buf + reader->pos, '\n', reader->len - reader->pos) ? TRUE : FALSE;
+}
+
+/**
+* @brief Reads a chunk of input
+*
+* command_reader_fill reads the descriptor once, after the partial
+* line kept. A line longer than the buffer is not a command, so it is
+* skipped up to its end. A caller that waits for the descriptor itself
+* calls it and then command_reader_pending, so a partial line does not
+* keep it reading
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param reader is the reader
+* @return ERROR if the input had already ended
+*/
+STATUS command_reader_fill(Command_reader *reader)
+{
+  char *end = NULL;
+  ssize_t n = 0;
+
+  if (!reader || reader->eof)
+    return ERROR;
+
+  if (reader->pos > 0)
+  {
+    memmove(reader->buf, reader->buf + reader->pos, reader->len - reader->pos);
+    reader->len -= reader->pos;
+    reader->pos = 0;
+  }
+  else if (reader->len == READER_SIZE)
+  {
+    reader->discarding = TRUE;
+    reader->len = 0;
+  }
+
+  if ((n = read(reader->fd, reader->buf + reader->len, READER_SIZE - reader->len)) > 0)
+    reader->len += n;
+  else if (n == 0 || errno != EINTR)
+    reader->eof = TRUE;
+
+  if (reader->discarding && (end = memchr(reader->buf, '\n', reader->len)))
+  {
+    reader->pos = end - reader->buf + 1;
+    reader->discarding = FALSE;
+  }
+  else if (reader->discarding)
+    reader->len = 0;
+
+  return OK;
+}
+
+/**
+* @brief Reads the next command
+*
+* command_reader_next parses the next line with a command, or the next
+* key in raw mode, reading a new chunk of input only when the buffer
+* has no full command left
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param reader is the reader
+* @param command is where the command is stored
+* @return ERROR at the end of the input
+*/
+STATUS command_reader_next(Command_reader *reader, Command *command)
+{
+  char *line = NULL, *end = NULL;
+
+  if (!reader || !command)
+    return ERROR;
+
+  while (reader->raw)
+  {
+    while (reader->pos < reader->len)
+    {
+      if (command_parse_key(reader->buf[reader->pos++], command) == OK)
+        return OK;
+    }
+
+    if (reader->eof)
+      return ERROR;
+    command_reader_fill(reader);
+  }
+
+  while (TRUE)
+  {
+    line = reader->buf + reader->pos;
+    if ((end = memchr(line, '\n', reader->len - reader->pos)))
+    {
+      reader->pos += end - line + 1;
+      if (command_parse(line, end - line, command) == OK)
+        return OK;
+      continue; /* Blank line */
+    }
+
+    if (reader->eof)
+    {
+      end = reader->buf + reader->len;
+      reader->pos = reader->len;
+      return (end > line) ? command_parse(line, end - line, command) : ERROR;
+    }
+
+    command_reader_fill(reader); /* Keeps the partial line and reads after it */
+  }
+}
+
+/**
+* @brief Parses a line
+*
+* command_parse takes the keyword and the first argument of a line
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param line is the line, not NULL-terminated
+* @param len is the length of the line
+* @param command is where the command is stored
+* @return ERROR if the line is blank
+*/
+STATUS command_parse(const char *line, size_t len, Command *command)
+{
+  size_t i = 0, word = 0, n = 0;
+
+  if (!line || !command)
+    return ERROR;
+
+  while (i < len && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r'))
+    i++;
+  if (i == len)
+    return ERROR;
+
+  for (word = i; i < len && line[i] != ' ' && line[i] != '\t' && line[i] != '\r'; i++)
+    ;
+  command->cmd = command_lookup(line + word, i - word);
+
+  while (i < len && (line[i] == ' ' || line[i] == '\t'))
+    i++;
+  for (n = 0; i < len && n < CMD_ARG_SIZE - 1 && line[i] != ' ' && line[i] != '\t' && line[i] != '\r'; i++)
+    command->arg[n++] = line[i];
+  command->arg[n] = '\0';
+
+  return OK;
+}
+
+/**
+* @brief Parses a key
+*
+* command_parse_key takes the command of a single key, which is
+* the short name of the command. Ctrl-C and Ctrl-D exit, and goto
+* is left out as it needs an argument
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param key is the key
+* @param command is where the command is stored
+* @return ERROR if the key is not a command
+*/
+STATUS command_parse_key(char key, Command *command)
+{
+  if (!command)
+    return ERROR;
+
+  command->arg[0] = '\0';
+  if (key == KEY_INTERRUPT || key == KEY_END)
+    command->cmd = EXIT;
+  else if ((command->cmd = command_lookup(&key, 1)) == UNKNOWN || command->cmd == GOTO)
+    return ERROR; /* Stray keys and escape sequences are ignored */
+
+  return OK;
+}
+
+/**
+* @brief Looks for a keyword
+*
+* command_lookup finds the command of a long or short name,
+* ignoring the case
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param word is the keyword, not NULL-terminated
+* @param len is the length of the keyword
+* @return the command or UNKNOWN
+*/
+T_Command command_lookup(const char *word, size_t len)
+{
+  const Command_keyword *entry = NULL;
+
+  entry = &cmd_hash_table[command_keyword_hash(word, len, CMD_HASH_SEED) & (CMD_HASH_SIZE - 1)];
+  if (entry->word && entry->len == len && !strncasecmp(entry->word, word, len))
+    return entry->cmd;
+
+  return UNKNOWN;
+}
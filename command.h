@@ -1,26 +1,48 @@
-/** 
- * @brief It implements the command interpreter
- * 
- * @file command.h
- * @author David Ramirez
- * @version 1.1 
- * @date 12/02/2019 
- */
-
-#ifndef COMMAND_H
-#define COMMAND_H
-
-typedef enum enum_Command
-{
-  NO_CMD = -1,
-  UNKNOWN,
-  EXIT,
-  NEXT,
-  BACK,
-  TAKE,
-  DROP
-} T_Command;
-
-T_Command get_user_input();
-
-#endif
+/** 
+ * @brief It implements the command interpreter
+ * 
+ * @file command.h
+ * @author David Ramirez
+ * @version 1.2 
+ * @date 19/10/2026 
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stddef.h>
+#include "types.h"
+
+#define CMD_ARG_SIZE 32
+
+typedef enum enum_Command
+{
+  NO_CMD = -1,
+#define CMD(id, name, short_name) id,
+#include "command.def"
+#undef CMD
+  N_COMMANDS
+} T_Command;
+
+/**
+ * @brief A command read from the input
+ */
+typedef struct _Command
+{
+  T_Command cmd;          /*!< The command */
+  char arg[CMD_ARG_SIZE]; /*!< Its first argument, empty if it has none */
+} Command;
+
+typedef struct _Command_reader Command_reader;
+
+Command_reader *command_reader_create(int fd);
+void command_reader_destroy(Command_reader *reader);
+STATUS command_reader_set_raw(Command_reader *reader, BOOL raw);
+BOOL command_reader_pending(Command_reader *reader);
+STATUS command_reader_fill(Command_reader *reader);
+STATUS command_reader_next(Command_reader *reader, Command *command);
+STATUS command_parse(const char *line, size_t len, Command *command);
+STATUS command_parse_key(char key, Command *command);
+T_Command command_lookup(const char *word, size_t len);
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @brief It generates the keyword table of the commands
+ *
+ * It is run at build time: it reads the keywords of command.def, looks
+ * for the seed that makes command_keyword_hash() free of collisions in
+ * the smallest table it can, and prints the table as a C header.
+ *
+ * @file command_gen.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "command_keyword.h"
+
+#define MAX_SEED 1000000UL
+
+/**
+ * @brief A keyword of the command list
+ */
+typedef struct _Keyword
+{
+  const char *word; /*!< Long or short name of the command */
+  const char *id;   /*!< Identifier of the command in the enumeration */
+} Keyword;
+
+static const Keyword keywords[] = {
+#define CMD(id, name, short_name) {name, #id}, {short_name, #id},
+#include "command.def"
+#undef CMD
+};
+
+#define N_KEYWORDS (sizeof(keywords) / sizeof(keywords[0]))
+
+int main()
+{
+  int slots[4 * N_KEYWORDS];
+  unsigned long size = 1, seed = 0, slot = 0;
+  size_t i = 0, n = 0;
+  char lower[64];
+
+  /* Unknown is what the parser returns on a miss, it is not a keyword */
+  while (size < N_KEYWORDS)
+    size <<= 1;
+
+  for (; size <= 4 * N_KEYWORDS; size <<= 1)
+  {
+    for (seed = 1; seed < MAX_SEED; seed++)
+    {
+      for (slot = 0; slot < size; slot++)
+        slots[slot] = -1;
+
+      for (i = 0; i < N_KEYWORDS; i++)
+      {
+        if (!*keywords[i].word || !strcmp(keywords[i].id, "UNKNOWN"))
+          continue;
+        slot = command_keyword_hash(keywords[i].word, strlen(keywords[i].word), seed) & (size - 1);
+        if (slots[slot] != -1)
+          break;
+        slots[slot] = (int)i;
+      }
+
+      if (i == N_KEYWORDS)
+        break;
+    }
+
+    if (seed < MAX_SEED)
+      break;
+  }
+
+  if (size > 4 * N_KEYWORDS)
+  {
+    fprintf(stderr, "command_gen: no perfect hash found\n");
+    return 1;
+  }
+
+  printf("/* Generated by command_gen from command.def, do not edit */\n\n");
+  printf("#define CMD_HASH_SEED %luUL\n", seed);
+  printf("#define CMD_HASH_SIZE %lu\n\n", size);
+  printf("static const Command_keyword cmd_hash_table[CMD_HASH_SIZE] = {\n");
+  for (slot = 0; slot < size; slot++)
+  {
+    if (slots[slot] == -1)
+    {
+      printf("    {NULL, 0, NO_CMD},\n");
+      continue;
+    }
+
+    for (n = 0; keywords[slots[slot]].word[n] && n < sizeof(lower) - 1; n++)
+    {
+      lower[n] = keywords[slots[slot]].word[n];
+      if (lower[n] >= 'A' && lower[n] <= 'Z')
+        lower[n] += 'a' - 'A';
+    }
+    lower[n] = '\0';
+    printf("    {\"%s\", %lu, %s},\n", lower, (unsigned long)n, keywords[slots[slot]].id);
+  }
+  printf("};\n");
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * @brief It defines the hash of the command keywords
+ *
+ * It is shared by command_gen, which looks for a seed that makes it
+ * perfect over the keywords, and by the parser, which uses that seed.
+ *
+ * @file command_keyword.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef COMMAND_KEYWORD_H
+#define COMMAND_KEYWORD_H
+
+#include <stddef.h>
+
+/**
+* @brief Computes the hash of a keyword
+*
+* command_keyword_hash mixes the characters of the keyword, ignoring
+* the case, with FNV-1a started from the seed
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param str is the keyword, not NULL-terminated
+* @param len is the length of the keyword
+* @param seed is the seed of the hash
+* @return the hash
+*/
+static unsigned long command_keyword_hash(const char *str, size_t len, unsigned long seed)
+{
+  unsigned long hash = 2166136261UL ^ (seed * 2654435761UL);
+  size_t i = 0;
+  unsigned char c = 0;
+
+  for (i = 0; i < len; i++)
+  {
+    c = (unsigned char)str[i];
+    if (c >= 'A' && c <= 'Z')
+      c += 'a' - 'A';
+    hash ^= c;
+    hash *= 16777619UL;
+  }
+
+  return hash ^ (hash >> 15);
+}
+
+#endif
@@ -0,0 +1,262 @@
+/**
+ * @brief It implements the binary protocol of the changes of a game
+ *
+ * Instead of the painted frame, a client of the binary protocol gets
+ * what changed in the state of its game since the last message, and
+ * paints the frame itself on its own copy of the world. A message is
+ * sent for every frame the server would have painted, so the client
+ * paints the same frames.
+ *
+ * A message is its length followed by a record for every field that
+ * changed: a tag and the new value. Every number is a varint, seven
+ * bits per byte with the lowest first, so moving the player to a near
+ * space and the command that did it take a few bytes. The first
+ * message says hello, with the version and the fingerprint of the
+ * world, and has the whole state.
+ *
+ * @file delta.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdio.h>
+#include "delta.h"
+
+/* Tags of the records */
+#define DELTA_HELLO 0   /* Version and fingerprint of the world */
+#define DELTA_PLAYER 1  /* Location of the player, plus one */
+#define DELTA_OBJECT 2  /* Location of the object, plus one */
+#define DELTA_CARRIED 3 /* Whether the object is carried */
+#define DELTA_COMMAND 4 /* Last command, minus NO_CMD */
+#define DELTA_MAP 5     /* Whether the map is shown */
+#define DELTA_SCROLL 6  /* Feedback lines scrolled back */
+
+#define DELTA_VARINT_MAX 10 /* Bytes of the longest varint */
+
+/****************************/
+/*     Private functions    */
+/****************************/
+size_t delta_put_varint(unsigned char *buf, unsigned long value);
+size_t delta_get_varint(const unsigned char *buf, size_t len, unsigned long *value);
+size_t delta_put_record(unsigned char *buf, int tag, unsigned long value);
+size_t delta_finish(unsigned char *buf, size_t body);
+
+/**
+* @brief Encodes the first message
+*
+* delta_encode_hello writes the hello and the whole state
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fingerprint is the fingerprint of the world of the game
+* @param state is the state of the game
+* @param buf is where the message is written, DELTA_MESSAGE_MAX bytes
+* @return the number of bytes of the message
+*/
+size_t delta_encode_hello(unsigned long fingerprint, const Game_state *state, unsigned char *buf)
+{
+  size_t len = 1; /* The length goes first, and it always takes one byte */
+
+  len += delta_put_record(buf + len, DELTA_HELLO, DELTA_VERSION);
+  len += delta_put_varint(buf + len, fingerprint);
+  len += delta_put_record(buf + len, DELTA_PLAYER, (unsigned long)(state->player_location + 1));
+  len += delta_put_record(buf + len, DELTA_OBJECT, (unsigned long)(state->object_location + 1));
+  len += delta_put_record(buf + len, DELTA_CARRIED, state->carried ? 1 : 0);
+  len += delta_put_record(buf + len, DELTA_COMMAND, (unsigned long)(state->last_cmd - NO_CMD));
+  len += delta_put_record(buf + len, DELTA_MAP, state->map_view ? 1 : 0);
+  len += delta_put_record(buf + len, DELTA_SCROLL, (unsigned long)state->scroll);
+
+  return delta_finish(buf, len - 1);
+}
+
+/**
+* @brief Encodes the changes of the state
+*
+* delta_encode writes a record for every field that changed. The
+* last command is always written, as it is added to the feedback
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param from is the state the client has
+* @param to is the new state
+* @param buf is where the message is written, DELTA_MESSAGE_MAX bytes
+* @return the number of bytes of the message
+*/
+size_t delta_encode(const Game_state *from, const Game_state *to, unsigned char *buf)
+{
+  size_t len = 1;
+
+  if (from->player_location != to->player_location)
+    len += delta_put_record(buf + len, DELTA_PLAYER, (unsigned long)(to->player_location + 1));
+  if (from->object_location != to->object_location)
+    len += delta_put_record(buf + len, DELTA_OBJECT, (unsigned long)(to->object_location + 1));
+  if (from->carried != to->carried)
+    len += delta_put_record(buf + len, DELTA_CARRIED, to->carried ? 1 : 0);
+  len += delta_put_record(buf + len, DELTA_COMMAND, (unsigned long)(to->last_cmd - NO_CMD));
+  if (from->map_view != to->map_view)
+    len += delta_put_record(buf + len, DELTA_MAP, to->map_view ? 1 : 0);
+  if (from->scroll != to->scroll)
+    len += delta_put_record(buf + len, DELTA_SCROLL, (unsigned long)to->scroll);
+
+  return delta_finish(buf, len - 1);
+}
+
+/**
+* @brief Decodes a message
+*
+* delta_decode applies the records of the first message of the buffer
+* to the state
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is the bytes received
+* @param len is the number of bytes
+* @param state is the state of the client, which is updated
+* @param fingerprint is where the fingerprint of a hello is written
+* @return the number of bytes of the message, 0 if it has not all been
+* received, or -1 if it is not valid
+*/
+long delta_decode(const unsigned char *buf, size_t len, Game_state *state, unsigned long *fingerprint)
+{
+  unsigned long body = 0, tag = 0, value = 0;
+  size_t at = 0, end = 0, n = 0;
+
+  if (!(at = delta_get_varint(buf, len, &body)))
+    return len < DELTA_VARINT_MAX ? 0 : -1;
+  if (body > DELTA_MESSAGE_MAX)
+    return -1;
+  if (len - at < body)
+    return 0;
+
+  for (end = at + body; at < end; at += n)
+  {
+    tag = buf[at++];
+    if (!(n = delta_get_varint(buf + at, end - at, &value)))
+      return -1;
+
+    switch (tag)
+    {
+    case DELTA_HELLO:
+      if (value != DELTA_VERSION)
+        return -1;
+      at += n;
+      if (!(n = delta_get_varint(buf + at, end - at, fingerprint)))
+        return -1;
+      break;
+    case DELTA_PLAYER:
+      state->player_location = (Id)value - 1;
+      break;
+    case DELTA_OBJECT:
+      state->object_location = (Id)value - 1;
+      break;
+    case DELTA_CARRIED:
+      state->carried = value ? TRUE : FALSE;
+      break;
+    case DELTA_COMMAND:
+      if (value >= (unsigned long)(N_COMMANDS - NO_CMD))
+        return -1;
+      state->last_cmd = (T_Command)((long)value + NO_CMD);
+      break;
+    case DELTA_MAP:
+      state->map_view = value ? TRUE : FALSE;
+      break;
+    case DELTA_SCROLL:
+      if (value > GAME_MAX_SCROLL)
+        return -1;
+      state->scroll = (int)value;
+      break;
+    default:
+      return -1;
+    }
+  }
+
+  return (long)end;
+}
+
+/**
+* @brief Writes a varint
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is where it is written
+* @param value is the number
+* @return the number of bytes written
+*/
+size_t delta_put_varint(unsigned char *buf, unsigned long value)
+{
+  size_t len = 0;
+
+  while (value >= 0x80)
+  {
+    buf[len++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  buf[len++] = (unsigned char)value;
+
+  return len;
+}
+
+/**
+* @brief Reads a varint
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is the bytes
+* @param len is the number of bytes
+* @param value is where the number is written
+* @return the number of bytes read, or 0 if it is not all there or
+* it is too long
+*/
+size_t delta_get_varint(const unsigned char *buf, size_t len, unsigned long *value)
+{
+  size_t i = 0;
+
+  *value = 0;
+  for (i = 0; i < len && i < DELTA_VARINT_MAX; i++)
+  {
+    *value |= (unsigned long)(buf[i] & 0x7f) << (7 * i);
+    if (!(buf[i] & 0x80))
+      return i + 1;
+  }
+
+  return 0;
+}
+
+/**
+* @brief Writes a record
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is where it is written
+* @param tag is the field
+* @param value is its value
+* @return the number of bytes written
+*/
+size_t delta_put_record(unsigned char *buf, int tag, unsigned long value)
+{
+  buf[0] = (unsigned char)tag;
+  return 1 + delta_put_varint(buf + 1, value);
+}
+
+/**
+* @brief Writes the length of a message before it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is the message, with a byte left for the length
+* @param body is the number of bytes after the length
+* @return the number of bytes of the message
+*/
+size_t delta_finish(unsigned char *buf, size_t body)
+{
+  buf[0] = (unsigned char)body; /* Never more than DELTA_MESSAGE_MAX, below 0x80 */
+  return body + 1;
+}
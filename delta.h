@@ -0,0 +1,23 @@
+/**
+ * @brief It defines the binary protocol of the changes of a game
+ *
+ * @file delta.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <stddef.h>
+#include "game.h"
+
+#define DELTA_VERSION 1
+#define DELTA_MESSAGE_MAX 96 /* Longest message, hello and whole state included */
+
+size_t delta_encode_hello(unsigned long fingerprint, const Game_state *state, unsigned char *buf);
+size_t delta_encode(const Game_state *from, const Game_state *to, unsigned char *buf);
+long delta_decode(const unsigned char *buf, size_t len, Game_state *state, unsigned long *fingerprint);
+
+#endif
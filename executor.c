@@ -0,0 +1,436 @@
+/**
+ * @brief It implements a pool of worker threads that steal work
+ *
+ * Every worker has its own deque of tasks. New tasks are spread over
+ * the deques in turns, a worker runs the tasks of its deque from the
+ * oldest, and when it has none it steals the newest task of another
+ * worker, so a busy worker is helped by the idle ones. A worker only
+ * sleeps when there is no task queued anywhere.
+ *
+ * A deque is only locked by its owner and by the thieves that try it,
+ * so the workers do not contend on a single queue.
+ *
+ * @file executor.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "executor.h"
+
+#define EXECUTOR_DEQUE_SIZE 64 /* First capacity of a deque, it grows when needed */
+
+/**
+ * @brief The tasks of a worker
+ */
+typedef struct _Executor_deque
+{
+  pthread_mutex_t lock; /*!< Taken by the owner and the thieves */
+  void **tasks;         /*!< Ring of the tasks */
+  int capacity;         /*!< Slots of the ring */
+  int head;             /*!< Slot of the oldest task */
+  int count;            /*!< Number of tasks */
+} Executor_deque;
+
+/**
+ * @brief A worker thread
+ */
+typedef struct _Executor_worker
+{
+  struct _Executor *executor; /*!< The executor it belongs to */
+  int id;                     /*!< Its number, from 0 */
+  pthread_t thread;           /*!< Its thread */
+  unsigned int seed;          /*!< State to choose whom to steal from */
+  Executor_deque deque;       /*!< Its tasks */
+  Executor_stats stats;       /*!< Its metrics */
+} Executor_worker;
+
+/**
+ * @brief The structure of the executor
+ */
+struct _Executor
+{
+  Executor_worker workers[EXECUTOR_MAX_WORKERS]; /*!< The workers */
+  int n_workers;                                 /*!< Number of workers */
+  executor_fn run;                               /*!< Runs a task */
+  void *data;                                    /*!< Passed to every run */
+  unsigned int next;                             /*!< Deque of the next task submitted */
+  int queued;                                    /*!< Tasks in all the deques */
+  int sleeping;                                  /*!< Workers waiting for tasks */
+  BOOL started;                                  /*!< Whether every worker has been started */
+  BOOL stop;                                     /*!< Whether the workers finish */
+  pthread_mutex_t idle_lock;                     /*!< Guards the sleep of the workers */
+  pthread_cond_t wake;                           /*!< Wakes up the workers */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+void *executor_worker(void *arg);
+STATUS executor_push(Executor_deque *deque, void *task);
+void *executor_pop(Executor_deque *deque);
+void *executor_steal(Executor_deque *deque);
+void *executor_find(Executor_worker *worker);
+
+/**
+* @brief Computes the creation of the executor
+*
+* executor_create starts the workers, which wait for tasks. They do
+* not look for them until all of them have been started, as they
+* steal from each other
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param n_workers is the number of workers
+* @param run is the function that runs a task
+* @param data is passed to every run
+* @return the new executor or NULL if it could not be started
+*/
+Executor *executor_create(int n_workers, executor_fn run, void *data)
+{
+  Executor *executor = NULL;
+  int i = 0;
+
+  if (n_workers < 1 || n_workers > EXECUTOR_MAX_WORKERS || !run)
+    return NULL;
+
+  if (!(executor = (Executor *)calloc(1, sizeof(Executor))))
+    return NULL;
+
+  executor->run = run;
+  executor->data = data;
+  pthread_mutex_init(&executor->idle_lock, NULL);
+  pthread_cond_init(&executor->wake, NULL);
+
+  for (i = 0; i < n_workers; i++)
+  {
+    executor->workers[i].executor = executor;
+    executor->workers[i].id = i;
+    executor->workers[i].seed = 2654435761U * (i + 1);
+    pthread_mutex_init(&executor->workers[i].deque.lock, NULL);
+    executor->workers[i].deque.capacity = EXECUTOR_DEQUE_SIZE;
+    if (!(executor->workers[i].deque.tasks = (void **)malloc(EXECUTOR_DEQUE_SIZE * sizeof(void *))))
+      break;
+    if (pthread_create(&executor->workers[i].thread, NULL, executor_worker, &executor->workers[i]) != 0)
+    {
+      free(executor->workers[i].deque.tasks);
+      break;
+    }
+    executor->n_workers++;
+  }
+
+  if (executor->n_workers < n_workers)
+  {
+    executor_destroy(executor);
+    return NULL;
+  }
+
+  pthread_mutex_lock(&executor->idle_lock);
+  executor->started = TRUE;
+  pthread_cond_broadcast(&executor->wake);
+  pthread_mutex_unlock(&executor->idle_lock);
+
+  return executor;
+}
+
+/**
+* @brief Computes the destruction of the executor
+*
+* executor_destroy lets the workers run the tasks left, waits for
+* them and frees the executor
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param executor is the executor
+*/
+void executor_destroy(Executor *executor)
+{
+  int i = 0;
+
+  if (!executor)
+    return;
+
+  pthread_mutex_lock(&executor->idle_lock);
+  executor->stop = TRUE;
+  pthread_cond_broadcast(&executor->wake);
+  pthread_mutex_unlock(&executor->idle_lock);
+
+  for (i = 0; i < executor->n_workers; i++)
+  {
+    pthread_join(executor->workers[i].thread, NULL);
+    pthread_mutex_destroy(&executor->workers[i].deque.lock);
+    free(executor->workers[i].deque.tasks);
+  }
+
+  pthread_cond_destroy(&executor->wake);
+  pthread_mutex_destroy(&executor->idle_lock);
+  free(executor);
+}
+
+/**
+* @brief Submits a task
+*
+* executor_submit queues the task in the deque of the next worker
+* and wakes up a worker if any is sleeping
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param executor is the executor
+* @param task is the task
+* @return the status
+*/
+STATUS executor_submit(Executor *executor, void *task)
+{
+  int i = 0;
+
+  if (!executor || !task)
+    return ERROR;
+
+  i = (int)(__atomic_fetch_add(&executor->next, 1, __ATOMIC_RELAXED) % (unsigned int)executor->n_workers);
+  if (executor_push(&executor->workers[i].deque, task) == ERROR)
+    return ERROR;
+
+  /* A worker going to sleep checks queued after counting itself as
+     sleeping, so one of the two always sees the other */
+  __atomic_add_fetch(&executor->queued, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&executor->sleeping, __ATOMIC_SEQ_CST) > 0)
+  {
+    pthread_mutex_lock(&executor->idle_lock);
+    pthread_cond_signal(&executor->wake);
+    pthread_mutex_unlock(&executor->idle_lock);
+  }
+
+  return OK;
+}
+
+/**
+* @brief Gets the number of workers
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param executor is the executor
+* @return the number of workers
+*/
+int executor_get_workers(Executor *executor)
+{
+  if (!executor)
+    return 0;
+
+  return executor->n_workers;
+}
+
+/**
+* @brief Gets the metrics of a worker
+*
+* executor_get_stats copies the metrics. They are read without
+* locking, so they can be a little behind while the workers run
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param executor is the executor
+* @param worker is the number of the worker
+* @param stats is where the metrics are copied
+*/
+void executor_get_stats(Executor *executor, int worker, Executor_stats *stats)
+{
+  if (!executor || !stats || worker < 0 || worker >= executor->n_workers)
+    return;
+
+  *stats = executor->workers[worker].stats;
+}
+
+/**
+* @brief Runs the tasks
+*
+* executor_worker is the thread of a worker. It runs its own tasks
+* or stolen ones until the executor is destroyed and nothing is left
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param arg is the worker
+* @return NULL
+*/
+void *executor_worker(void *arg)
+{
+  Executor_worker *worker = (Executor_worker *)arg;
+  Executor *executor = worker->executor;
+  void *task = NULL;
+  BOOL stop = FALSE;
+
+  /* The number of workers is not known until all have been started */
+  pthread_mutex_lock(&executor->idle_lock);
+  while (!executor->started && !executor->stop)
+    pthread_cond_wait(&executor->wake, &executor->idle_lock);
+  pthread_mutex_unlock(&executor->idle_lock);
+
+  while (!stop)
+  {
+    if ((task = executor_find(worker)))
+    {
+      __atomic_sub_fetch(&executor->queued, 1, __ATOMIC_SEQ_CST);
+      executor->run(executor->data, task, worker->id);
+      worker->stats.runs++;
+      continue;
+    }
+
+    pthread_mutex_lock(&executor->idle_lock);
+    __atomic_add_fetch(&executor->sleeping, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&executor->queued, __ATOMIC_SEQ_CST) == 0 && !executor->stop)
+    {
+      worker->stats.sleeps++;
+      pthread_cond_wait(&executor->wake, &executor->idle_lock);
+    }
+    __atomic_sub_fetch(&executor->sleeping, 1, __ATOMIC_SEQ_CST);
+    stop = executor->stop && __atomic_load_n(&executor->queued, __ATOMIC_SEQ_CST) == 0;
+    pthread_mutex_unlock(&executor->idle_lock);
+  }
+
+  return NULL;
+}
+
+/**
+* @brief Finds a task for a worker
+*
+* executor_find takes the oldest task of the worker, or else steals
+* one, trying the other workers from a random one
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param worker is the worker
+* @return the task or NULL if there is none
+*/
+void *executor_find(Executor_worker *worker)
+{
+  Executor *executor = worker->executor;
+  void *task = NULL;
+  int first = 0, i = 0;
+
+  if ((task = executor_pop(&worker->deque)))
+    return task;
+
+  worker->seed ^= worker->seed << 13;
+  worker->seed ^= worker->seed >> 17;
+  worker->seed ^= worker->seed << 5;
+  first = (int)(worker->seed % (unsigned int)executor->n_workers);
+
+  for (i = 0; i < executor->n_workers; i++)
+  {
+    if ((first + i) % executor->n_workers == worker->id)
+      continue;
+    if ((task = executor_steal(&executor->workers[(first + i) % executor->n_workers].deque)))
+    {
+      worker->stats.steals++;
+      return task;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+* @brief Queues a task as the newest of a deque
+*
+* executor_push doubles the ring when it is full
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param deque is the deque
+* @param task is the task
+* @return ERROR if there is no memory
+*/
+STATUS executor_push(Executor_deque *deque, void *task)
+{
+  void **tasks = NULL;
+  int i = 0;
+
+  pthread_mutex_lock(&deque->lock);
+  if (deque->count == deque->capacity)
+  {
+    if (!(tasks = (void **)malloc(2 * deque->capacity * sizeof(void *))))
+    {
+      pthread_mutex_unlock(&deque->lock);
+      return ERROR;
+    }
+    for (i = 0; i < deque->count; i++)
+      tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+    free(deque->tasks);
+    deque->tasks = tasks;
+    deque->head = 0;
+    deque->capacity *= 2;
+  }
+
+  deque->tasks[(deque->head + deque->count) % deque->capacity] = task;
+  deque->count++;
+  pthread_mutex_unlock(&deque->lock);
+
+  return OK;
+}
+
+/**
+* @brief Takes the oldest task of a deque
+*
+* executor_pop is used by the owner, so the tasks of a worker run
+* in the order they came
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param deque is the deque
+* @return the task or NULL if it is empty
+*/
+void *executor_pop(Executor_deque *deque)
+{
+  void *task = NULL;
+
+  pthread_mutex_lock(&deque->lock);
+  if (deque->count > 0)
+  {
+    task = deque->tasks[deque->head];
+    deque->head = (deque->head + 1) % deque->capacity;
+    deque->count--;
+  }
+  pthread_mutex_unlock(&deque->lock);
+
+  return task;
+}
+
+/**
+* @brief Takes the newest task of a deque
+*
+* executor_steal is used by the other workers. It takes the task the
+* owner would run last, and does not wait if the deque is busy
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param deque is the deque
+* @return the task or NULL if there is none to take
+*/
+void *executor_steal(Executor_deque *deque)
+{
+  void *task = NULL;
+
+  if (__atomic_load_n(&deque->count, __ATOMIC_RELAXED) == 0 || pthread_mutex_trylock(&deque->lock) != 0)
+    return NULL;
+
+  if (deque->count > 0)
+  {
+    deque->count--;
+    task = deque->tasks[(deque->head + deque->count) % deque->capacity];
+  }
+  pthread_mutex_unlock(&deque->lock);
+
+  return task;
+}
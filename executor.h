@@ -0,0 +1,43 @@
+/**
+ * @brief It defines a pool of worker threads that steal work
+ *
+ * @file executor.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include "types.h"
+
+#define EXECUTOR_MAX_WORKERS 64
+
+typedef struct _Executor Executor;
+
+/**
+ * @brief Runs a task
+ *
+ * worker is the number of the worker running it, from 0, so the
+ * task can use what belongs to that worker without locking
+ */
+typedef void (*executor_fn)(void *data, void *task, int worker);
+
+/**
+ * @brief The metrics of a worker
+ */
+typedef struct _Executor_stats
+{
+  unsigned long runs;   /*!< Tasks run */
+  unsigned long steals; /*!< Tasks taken from another worker */
+  unsigned long sleeps; /*!< Times it waited for work */
+} Executor_stats;
+
+Executor *executor_create(int n_workers, executor_fn run, void *data);
+void executor_destroy(Executor *executor);
+STATUS executor_submit(Executor *executor, void *task);
+int executor_get_workers(Executor *executor);
+void executor_get_stats(Executor *executor, int worker, Executor_stats *stats);
+
+#endif
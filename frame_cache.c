@@ -0,0 +1,280 @@
+/**
+ * @brief It implements a bounded cache of composed frames
+ *
+ * The cache is direct mapped: every key hashes to one slot and a
+ * new frame simply replaces whatever was stored there, so memory
+ * never grows past FRAME_CACHE_SIZE frames.
+ *
+ * @file frame_cache.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "frame_cache.h"
+
+#define FNV_OFFSET 2166136261UL
+#define FNV_PRIME 16777619UL
+
+/**
+ * @brief A slot of the cache
+ *
+ * It stores the key of the frame, its hash and the bytes
+ * ready to be written to the terminal
+ */
+typedef struct _Frame_entry
+{
+  BOOL used;          /*!< Whether the slot holds a frame */
+  unsigned long hash; /*!< Hash of the key */
+  Frame_key key;      /*!< Inputs the frame was composed from */
+  char *frame;        /*!< Composed output bytes */
+  size_t len;         /*!< Number of bytes of the frame */
+  size_t size;        /*!< Allocated bytes of the frame */
+} Frame_entry;
+
+/**
+ * @brief The structure of the frame cache
+ *
+ * It stores the slots and the hit and miss counters
+ */
+struct _Frame_cache
+{
+  Frame_entry entries[FRAME_CACHE_SIZE]; /*!< Slots of the cache */
+  unsigned long hits;                    /*!< Lookups served from the cache, stored atomically */
+  unsigned long misses;                  /*!< Lookups that had to compose the frame, stored atomically */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+unsigned long frame_cache_hash(const Frame_key *key);
+BOOL frame_cache_key_equals(const Frame_key *a, const Frame_key *b);
+
+/**
+* @brief Computes the creation of the frame cache
+*
+* frame_cache_create creates an empty frame cache
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @return the new cache or NULL if there is no memory
+*/
+Frame_cache *frame_cache_create()
+{
+  Frame_cache *cache = NULL;
+
+  cache = (Frame_cache *)calloc(1, sizeof(Frame_cache));
+
+  return cache;
+}
+
+/**
+* @brief Computes the destruction of the frame cache
+*
+* frame_cache_destroy frees the cache and every stored frame
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param cache is the cache which is going to be destroyed
+*/
+void frame_cache_destroy(Frame_cache *cache)
+{
+  int i = 0;
+
+  if (!cache)
+    return;
+
+  for (i = 0; i < FRAME_CACHE_SIZE; i++)
+  {
+    free(cache->entries[i].frame);
+  }
+  free(cache);
+}
+
+/**
+* @brief Looks for a composed frame
+*
+* frame_cache_get returns the frame stored for a key and
+* updates the hit and miss counters
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param cache is the cache
+* @param key is the inputs of the frame
+* @param len is where the length of the frame is stored
+* @return the bytes of the frame or NULL if it is not cached
+*/
+const char *frame_cache_get(Frame_cache *cache, const Frame_key *key, size_t *len)
+{
+  Frame_entry *entry = NULL;
+  unsigned long hash = 0;
+
+  if (!cache || !key || !len)
+    return NULL;
+
+  hash = frame_cache_hash(key);
+  entry = &cache->entries[hash % FRAME_CACHE_SIZE];
+
+  if (entry->used && entry->hash == hash && frame_cache_key_equals(&entry->key, key))
+  {
+    /* Only the owner writes them, another thread may read them */
+    __atomic_store_n(&cache->hits, cache->hits + 1, __ATOMIC_RELAXED);
+    *len = entry->len;
+    return entry->frame;
+  }
+
+  __atomic_store_n(&cache->misses, cache->misses + 1, __ATOMIC_RELAXED);
+  return NULL;
+}
+
+/**
+* @brief Stores a composed frame
+*
+* frame_cache_put copies the frame into the slot of its key,
+* replacing the frame that was there before
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param cache is the cache
+* @param key is the inputs of the frame
+* @param frame is the composed output bytes
+* @param len is the number of bytes of the frame
+* @return the status
+*/
+STATUS frame_cache_put(Frame_cache *cache, const Frame_key *key, const char *frame, size_t len)
+{
+  Frame_entry *entry = NULL;
+  unsigned long hash = 0;
+  char *aux = NULL;
+
+  if (!cache || !key || !frame)
+    return ERROR;
+
+  hash = frame_cache_hash(key);
+  entry = &cache->entries[hash % FRAME_CACHE_SIZE];
+
+  if (entry->size < len)
+  {
+    if (!(aux = (char *)realloc(entry->frame, len)))
+      return ERROR;
+    entry->frame = aux;
+    entry->size = len;
+  }
+
+  memcpy(entry->frame, frame, len);
+  entry->len = len;
+  entry->key = *key;
+  entry->hash = hash;
+  entry->used = TRUE;
+
+  return OK;
+}
+
+/**
+* @brief gets the number of hits
+*
+* frame_cache_hits gets how many lookups were served from the cache,
+* also from another thread than the one using the cache
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param cache is the cache
+* @return the number of hits
+*/
+unsigned long frame_cache_hits(Frame_cache *cache)
+{
+  if (!cache)
+    return 0;
+  return __atomic_load_n(&cache->hits, __ATOMIC_RELAXED);
+}
+
+/**
+* @brief gets the number of misses
+*
+* frame_cache_misses gets how many lookups were not in the cache
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param cache is the cache
+* @return the number of misses
+*/
+unsigned long frame_cache_misses(Frame_cache *cache)
+{
+  if (!cache)
+    return 0;
+  return __atomic_load_n(&cache->misses, __ATOMIC_RELAXED);
+}
+
+/**
+* @brief Computes the hash of a key
+*
+* frame_cache_hash mixes every field of the key with FNV-1a
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param key is the key
+* @return the hash
+*/
+unsigned long frame_cache_hash(const Frame_key *key)
+{
+  unsigned long hash = FNV_OFFSET;
+  long fields[4 + FRAME_KEY_HISTORY];
+  int i = 0;
+
+  fields[0] = key->player_location;
+  fields[1] = key->object_location;
+  fields[2] = key->carried;
+  fields[3] = key->map_view;
+  for (i = 0; i < FRAME_KEY_HISTORY; i++)
+  {
+    fields[4 + i] = key->history[i];
+  }
+
+  for (i = 0; i < 4 + FRAME_KEY_HISTORY; i++)
+  {
+    hash ^= (unsigned long)fields[i];
+    hash *= FNV_PRIME;
+  }
+
+  return hash;
+}
+
+/**
+* @brief Compares two keys
+*
+* frame_cache_key_equals compares the keys field by field
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param a is the first key
+* @param b is the second key
+* @return TRUE if both keys are the same
+*/
+BOOL frame_cache_key_equals(const Frame_key *a, const Frame_key *b)
+{
+  int i = 0;
+
+  if (a->player_location != b->player_location ||
+      a->object_location != b->object_location ||
+      a->carried != b->carried ||
+      a->map_view != b->map_view)
+    return FALSE;
+
+  for (i = 0; i < FRAME_KEY_HISTORY; i++)
+  {
+    if (a->history[i] != b->history[i])
+      return FALSE;
+  }
+
+  return TRUE;
+}
@@ -0,0 +1,44 @@
+/**
+ * @brief It defines a bounded cache of composed frames
+ *
+ * @file frame_cache.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <stddef.h>
+#include "types.h"
+
+#define FRAME_CACHE_SIZE 64
+#define FRAME_KEY_HISTORY 3
+#define FRAME_EMPTY_LINE -2
+
+/**
+ * @brief The inputs a frame is computed from
+ *
+ * The feedback area shows the last painted commands, so they
+ * are part of the key together with the visible game state
+ */
+typedef struct _Frame_key
+{
+  Id player_location;                /*!< Space where the player is */
+  Id object_location;                /*!< Space where the object is */
+  BOOL carried;                      /*!< Whether the player carries the object */
+  BOOL map_view;                     /*!< Whether the whole map is shown */
+  int history[FRAME_KEY_HISTORY];    /*!< Commands shown in the feedback area, oldest first */
+} Frame_key;
+
+typedef struct _Frame_cache Frame_cache;
+
+Frame_cache *frame_cache_create();
+void frame_cache_destroy(Frame_cache *cache);
+const char *frame_cache_get(Frame_cache *cache, const Frame_key *key, size_t *len);
+STATUS frame_cache_put(Frame_cache *cache, const Frame_key *key, const char *frame, size_t len);
+unsigned long frame_cache_hits(Frame_cache *cache);
+unsigned long frame_cache_misses(Frame_cache *cache);
+
+#endif
@@ -1,522 +1,1469 @@
-/** 
- * @brief It implements the game interface and all the associated callbacks
- * for each command
- * 
- * @file game.c
- * @author David Ramirez
- * @version 1.1 
- * @date 18/01/2019 
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "game.h"
-#include "game_reader.h"
-#define N_CALLBACK 6
-
-/**
-   Define the function type for the callbacks
-*/
-typedef void (*callback_fn)(Game *game);
-
-/**
-   List of callbacks for each command in the game 
-*/
-void game_callback_unknown(Game *game);
-void game_callback_exit(Game *game);
-void game_callback_next(Game *game);
-void game_callback_back(Game *game);
-void game_callback_take(Game *game);
-void game_callback_drop(Game *game);
-
-static callback_fn game_callback_fn_list[N_CALLBACK] = {
-    game_callback_unknown,
-    game_callback_exit,
-    game_callback_next,
-    game_callback_back,
-    game_callback_take,
-    game_callback_drop};
-
-/**
-   Private functions
-*/
-
-/*STATUS game_load_spaces(Game* game, char* filename);*/
-STATUS game_add_space(Game *game, Space *space);
-Id game_get_space_id_at(Game *game, int position);
-STATUS game_set_player_location(Game *game, Id id);
-STATUS game_set_object_location(Game *game, Id id);
-
-/**
-   Game interface implementation
-*/
-
-/**
-* @brief Computes the creation of the game
-*
-* game_create_from_file creates the game, loading all necessary information
-* from a file
-*
-* @date 11/02/2019
-* @author David Ramirez
-* @param game is the game is going to be created
-* @param filename is the file which is going to be read
-* @return the status (if the game has been created successfully or not)
-*/
-STATUS game_create_from_file(Game *game, char *filename)
-{
-  if (game_create(game) == ERROR)
-    return ERROR;
-
-  if (game_reader_load_spaces(game, filename) == ERROR)
-    return ERROR;
-
-  game_set_player_location(game, game_get_space_id_at(game, 0));
-  game_set_object_location(game, game_get_space_id_at(game, 0));
-
-  return OK;
-}
-
-/**
-* @brief Computes the creation of the player, object, spaces 
-* and commands
-*
-* game_create creates all necessary things for the game
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @return the status
-*/
-STATUS game_create(Game *game)
-{
-  int i;
-
-  for (i = 0; i < MAX_SPACES; i++)
-  {
-    game->spaces[i] = NULL;
-  }
-
-  game->player = player_create(NO_ID); /*Creates the player*/
-  game->object = object_create(NO_ID); /*Creates the object*/
-  game->last_cmd = NO_CMD;
-
-  return OK;
-}
-
-/**
-* @brief Computes the destruction of the game
-*
-* game_destroy destroys the game
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @return the status
-*/
-STATUS game_destroy(Game *game)
-{
-  int i = 0;
-
-  for (i = 0; (i < MAX_SPACES) && (game->spaces[i] != NULL); i++)
-  {
-    space_destroy(game->spaces[i]);
-  }
-  object_destroy(game->object);
-  player_destroy(game->player);
-
-  return OK;
-}
-
-/**
-* @brief Computes the creation of a new space
-*
-* game_add_space add a new space
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @param space is the space we want to create
-* @return the status
-*/
-STATUS game_add_space(Game *game, Space *space)
-{
-  int i = 0;
-
-  if (space == NULL)
-  {
-    return ERROR;
-  }
-
-  while ((i < MAX_SPACES) && (game->spaces[i] != NULL))
-  {
-    i++;
-  }
-
-  if (i >= MAX_SPACES)
-  {
-    return ERROR;
-  }
-
-  game->spaces[i] = space;
-
-  return OK;
-}
-
-/**
-* @brief gets the id of the space in the position we want
-*
-* game_get_space_id_at gets the id of the space we want
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @param position is the space whose id we want to know
-* @return the id of the space
-*/
-Id game_get_space_id_at(Game *game, int position)
-{
-
-  if (position < 0 || position >= MAX_SPACES)
-  {
-    return NO_ID;
-  }
-
-  return space_get_id(game->spaces[position]);
-}
-
-/**
-* @brief gets the id of the space in the position we want
-*
-* game_get_space gets the id of the space we want
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @param id is the identification number
-* @return the space
-*/
-Space *game_get_space(Game *game, Id id)
-{
-  int i = 0;
-
-  if (id == NO_ID)
-  {
-    return NULL;
-  }
-
-  for (i = 0; i < MAX_SPACES && game->spaces[i] != NULL; i++)
-  {
-    if (id == space_get_id(game->spaces[i]))
-    {
-      return game->spaces[i];
-    }
-  }
-
-  return NULL;
-}
-
-/**
-* @brief sets the location
-*
-* game_set_player_location sets the location of the player
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @param id is the identification number
-* @return the status
-*/
-STATUS game_set_player_location(Game *game, Id id)
-{
-
-  if (id == NO_ID)
-  {
-    return ERROR;
-  }
-
-  player_set_location(game->player, id);
-
-  return OK;
-}
-
-/**
-* @brief sets the location
-*
-* game_set_object_location sets the location of the object
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @param id is the identification number
-* @return the status
-*/
-STATUS game_set_object_location(Game *game, Id id)
-{
-  if (id == NO_ID)
-  {
-    return ERROR;
-  }
-
-  object_set_id(game->object, id);
-
-  return OK;
-}
-
-/**
-* @brief gets the location
-*
-* game_get_player_location gets the location of the player
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @return the id of the location
-*/
-Id game_get_player_location(Game *game)
-{
-  return player_get_location(game->player);
-}
-
-/**
-* @brief gets the location
-*
-* game_get_object_location gets the location of the object
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @return the id of the location
-*/
-Id game_get_object_location(Game *game)
-{
-  return object_get_id(game->object);
-}
-
-/**
-* @brief Computes the updating of the callbacks
-*
-* game_update updates the callbacks
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @param cmd is the command written in the terminal
-* @return the status
-*/
-STATUS game_update(Game *game, T_Command cmd)
-{
-  game->last_cmd = cmd;
-  (*game_callback_fn_list[cmd])(game);
-  return OK;
-}
-
-/**
-* @brief Computes the last command written
-*
-* game_get_last_command gets the last command written
-*
-* @date 08/02/2019
-* @author David Ramirez
-* @param game is the game
-* @return the command written
-*/
-T_Command game_get_last_command(Game *game)
-{
-  return game->last_cmd;
-}
-
-/**
-* @brief Prints the information we want to know
-*
-* game_print_data prints the location of the object and the player
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game
-*/
-void game_print_data(Game *game)
-{
-  int i = 0;
-
-  printf("\n\n-------------\n\n");
-
-  printf("=> Spaces: \n");
-  for (i = 0; i < MAX_SPACES && game->spaces[i] != NULL; i++)
-  {
-    space_print(game->spaces[i]);
-  }
-
-  printf("=> Object location: %ld\n", object_get_id(game->object));
-  printf("=> Player location: %ld\n", player_get_id(game->player));
-  printf("prompt:> ");
-}
-
-/**
-* @brief when the game ends
-*
-* game_is_over used when the game ends
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game is the game
-* @return FALSE
-*/
-BOOL game_is_over(Game *game)
-{
-  return FALSE;
-}
-
-/**
-   Callbacks implementation for each action 
-*/
-
-/**
-* @brief when there is and unknown command, it does not do anything
-*
-* game_callback_unknown used if something unknown is written with the keyboard
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game is the game
-* @return it doesn't return anything because it's type void
-*/
-void game_callback_unknown(Game *game)
-{
-}
-
-/**
-* @brief when write e with the keyboard, exit the game
-*
-* game_callback_exit used to go exit the game
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game is the game
-* @return it doesn't return anything because it's type void
-*/
-void game_callback_exit(Game *game)
-{
-}
-
-/**
-* @brief when write n with the keyboard, go to the next space in the game
-*
-* game_callback_next used to go to the next space
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game is the game
-* @return it doesn't return anything because it's type void
-*/
-void game_callback_next(Game *game)
-{
-  int i = 0;
-  Id current_id = NO_ID;
-  Id space_id = NO_ID;
-
-  space_id = game_get_player_location(game);
-  if (space_id == NO_ID)
-  {
-    return;
-  }
-
-  for (i = 0; i < MAX_SPACES && game->spaces[i] != NULL; i++)
-  {
-    current_id = space_get_id(game->spaces[i]);
-    if (current_id == space_id)
-    {
-      current_id = space_get_south(game->spaces[i]);
-      if (current_id != NO_ID)
-      {
-        game_set_player_location(game, current_id);
-        if (player_object(game->player) == TRUE)
-        {
-          game_set_object_location(game, current_id);
-        }
-      }
-      return;
-    }
-  }
-}
-
-/**
-* @brief when write b with the keyboard, go a space back in the game
-*
-* game_callback_back used to go to the back space
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game is the game
-* @return it doesn't return anything because it's type void
-*/
-void game_callback_back(Game *game)
-{
-  int i = 0;
-  Id current_id = NO_ID;
-  Id space_id = NO_ID;
-
-  space_id = game_get_player_location(game);
-
-  if (NO_ID == space_id)
-  {
-    return;
-  }
-
-  for (i = 0; i < MAX_SPACES && game->spaces[i] != NULL; i++)
-  {
-    current_id = space_get_id(game->spaces[i]);
-    if (current_id == space_id)
-    {
-      current_id = space_get_north(game->spaces[i]);
-      if (current_id != NO_ID)
-      {
-        game_set_player_location(game, current_id);
-        if (player_object(game->player) == TRUE)
-        {
-          game_set_object_location(game, current_id);
-        }
-      }
-      return;
-    }
-  }
-}
-
-/**
-* @brief when write t with the keyboard, take the object
-*
-* game_callback_take takes the object
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game is the game where we want to take an object
-* @return it doesn't return anything because it's type void
-*/
-void game_callback_take(Game *game)
-{
-  player_take_object(game->player, object_get_id(game->object));
-}
-
-/**
-* @brief when write d with the keyboard, drops the object
-*
-* game_callback_drop drops the object
-*
-* @date 12/02/2019
-* @author David Ramirez
-*
-* @param game is the game where we want to drop an object
-* @return it doesn't return anything because it's type void
-*/
-void game_callback_drop(Game *game)
-{
-  player_drop_object(game->player);
-}
+/** 
+ * @brief It implements the game interface and all the associated callbacks
+ * for each command
+ * 
+ * @file game.c
+ * @author David Ramirez
+ * @version 1.1 
+ * @date 18/01/2019 
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "game.h"
+#define N_CALLBACK N_COMMANDS
+
+/* Layout of a snapshot, every number little endian */
+#define SNAPSHOT_MAGIC "OCAS"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_VERSION_AT 4   /* 4 bytes */
+#define SNAPSHOT_WORLD_AT 8     /* 8 bytes, fingerprint of the spaces */
+#define SNAPSHOT_PLAYER_AT 16   /* 8 bytes */
+#define SNAPSHOT_OBJECT_AT 24   /* 8 bytes */
+#define SNAPSHOT_CARRIED_AT 32  /* 1 byte */
+#define SNAPSHOT_LAST_CMD_AT 33 /* 1 byte, the command plus one */
+#define SNAPSHOT_MAP_VIEW_AT 34 /* 1 byte */
+#define SNAPSHOT_SCROLL_AT 36   /* 4 bytes */
+#define SNAPSHOT_HASH_AT 40     /* 8 bytes, hash of the state */
+#define SNAPSHOT_SEQUENCE_AT 48 /* 8 bytes, commands of the journal in the state */
+#define SNAPSHOT_SIZE 56
+
+/* Layout of an encoded game, a snapshot followed by the history */
+#define ENCODED_UNDO_AT SNAPSHOT_SIZE        /* 2 bytes */
+#define ENCODED_REDO_AT (SNAPSHOT_SIZE + 2)  /* 2 bytes */
+#define ENCODED_HISTORY_AT (SNAPSHOT_SIZE + 4)
+#define ENCODED_DELTA_SIZE 17                /* 8 + 8 + 1 bytes, oldest first */
+
+#define HASH_PLAYER 1  /* Roles of an id in the hash of the state */
+#define HASH_OBJECT 2
+#define HASH_CARRIED 3
+
+/**
+   Define the function type for the callbacks
+*/
+typedef void (*callback_fn)(Game *game, const char *arg);
+
+/**
+   List of callbacks for each command in the game 
+*/
+void game_callback_unknown(Game *game, const char *arg);
+void game_callback_exit(Game *game, const char *arg);
+void game_callback_next(Game *game, const char *arg);
+void game_callback_back(Game *game, const char *arg);
+void game_callback_take(Game *game, const char *arg);
+void game_callback_drop(Game *game, const char *arg);
+void game_callback_map(Game *game, const char *arg);
+void game_callback_up(Game *game, const char *arg);
+void game_callback_down(Game *game, const char *arg);
+void game_callback_goto(Game *game, const char *arg);
+void game_callback_undo(Game *game, const char *arg);
+void game_callback_redo(Game *game, const char *arg);
+long game_move(Game *game, DIRECTION direction, long count);
+long game_repeat_count(const char *arg);
+unsigned long game_hash_key(int role, Id id);
+void game_record(Game *game, Id player, Id object, BOOL carried);
+void game_apply_delta(Game *game, const Game_delta *delta);
+
+static const callback_fn game_callback_fn_list[N_CALLBACK] = {
+    game_callback_unknown,
+    game_callback_exit,
+    game_callback_next,
+    game_callback_back,
+    game_callback_take,
+    game_callback_drop,
+    game_callback_map,
+    game_callback_up,
+    game_callback_down,
+    game_callback_goto,
+    game_callback_undo,
+    game_callback_redo};
+
+/**
+   Private functions
+*/
+
+/*STATUS game_load_spaces(Game* game, char* filename);*/
+Id game_get_space_id_at(Game *game, int position);
+STATUS game_set_player_location(Game *game, Id id);
+STATUS game_set_object_location(Game *game, Id id);
+STATUS game_take_object(Game *game);
+STATUS game_drop_object(Game *game);
+unsigned long game_compute_hash(Game *game);
+void game_put_number(unsigned char *buf, unsigned long value, int len);
+unsigned long game_get_number(const unsigned char *buf, int len);
+void game_snapshot_encode(Game *game, unsigned char *buf);
+STATUS game_snapshot_decode(Game *game, const unsigned char *buf);
+
+/**
+   Game interface implementation
+*/
+
+/**
+* @brief Computes the creation of the game
+*
+* game_create_from_file creates the game, loading all necessary information
+* from a file
+*
+* @date 11/02/2019
+* @author David Ramirez
+* @param game is the game is going to be created
+* @param filename is the file which is going to be read
+* @return the status (if the game has been created successfully or not)
+*/
+STATUS game_create_from_file(Game *game, char *filename)
+{
+  World *world = NULL;
+  STATUS status = ERROR;
+
+  world = world_create_from_file(filename);
+  status = game_create_from_world(game, world);
+  world_release(world); /* The game keeps its own reference */
+
+  return status;
+}
+
+/**
+* @brief Computes the creation of a game on a world
+*
+* game_create_from_world creates the player and the object on the
+* first space of a world loaded before, which is shared and not
+* copied. The game can be destroyed even if it fails
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game is going to be created
+* @param world is the world
+* @return the status
+*/
+STATUS game_create_from_world(Game *game, World *world)
+{
+  game->world = world_retain(world);
+  game->player = player_create(NO_ID); /*Creates the player*/
+  game->object = object_create(NO_ID); /*Creates the object*/
+  game->last_cmd = NO_CMD;
+  game->map_view = FALSE;
+  game->scroll = 0;
+  game->journal = NULL;
+  game->sequence = 0;
+  game->history = NULL; /* Only allocated on the first change */
+  game->history_top = 0;
+  game->undo_count = game->redo_count = 0;
+  game->hash = game_compute_hash(game);
+
+  if (!game->world || !game->player || !game->object)
+    return ERROR;
+
+  game_set_player_location(game, game_get_space_id_at(game, 0));
+  game_set_object_location(game, game_get_space_id_at(game, 0));
+
+  return OK;
+}
+
+/**
+* @brief Computes the creation of the player, object, spaces 
+* and commands
+*
+* game_create creates all necessary things for the game
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @return the status
+*/
+STATUS game_create(Game *game)
+{
+  World *world = NULL;
+  STATUS status = ERROR;
+
+  world = world_create();
+  status = game_create_from_world(game, world);
+  world_release(world);
+
+  return status;
+}
+
+/**
+* @brief Computes the destruction of the game
+*
+* game_destroy destroys the game
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @return the status
+*/
+STATUS game_destroy(Game *game)
+{
+  object_destroy(game->object);
+  player_destroy(game->player);
+  free(game->history);
+  world_release(game->world);
+  game->object = NULL;
+  game->player = NULL;
+  game->history = NULL;
+  game->world = NULL;
+
+  return OK;
+}
+
+/**
+* @brief gets the id of the space in the position we want
+*
+* game_get_space_id_at gets the id of the space we want
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @param position is the space whose id we want to know
+* @return the id of the space
+*/
+Id game_get_space_id_at(Game *game, int position)
+{
+  return space_get_id(world_get_space_at(game->world, position));
+}
+
+/**
+* @brief gets the id of the space in the position we want
+*
+* game_get_space gets the space of an id from the index
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @param id is the identification number
+* @return the space
+*/
+Space *game_get_space(Game *game, Id id)
+{
+  return world_get_space(game->world, id);
+}
+
+/**
+* @brief sets the location
+*
+* game_set_player_location sets the location of the player and
+* updates the hash of the state
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @param id is the identification number
+* @return the status
+*/
+STATUS game_set_player_location(Game *game, Id id)
+{
+
+  if (id == NO_ID)
+  {
+    return ERROR;
+  }
+
+  game->hash ^= game_hash_key(HASH_PLAYER, game_get_player_location(game)) ^ game_hash_key(HASH_PLAYER, id);
+  player_set_location(game->player, id);
+
+  return OK;
+}
+
+/**
+* @brief sets the location
+*
+* game_set_object_location sets the location of the object and
+* updates the hash of the state
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @param id is the identification number
+* @return the status
+*/
+STATUS game_set_object_location(Game *game, Id id)
+{
+  if (id == NO_ID)
+  {
+    return ERROR;
+  }
+
+  game->hash ^= game_hash_key(HASH_OBJECT, game_get_object_location(game)) ^ game_hash_key(HASH_OBJECT, id);
+  object_set_id(game->object, id);
+
+  return OK;
+}
+
+/**
+* @brief takes the object
+*
+* game_take_object makes the player carry the object, brings it to
+* the space of the player and updates the hash of the state
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return the status
+*/
+STATUS game_take_object(Game *game)
+{
+  BOOL carried = game_get_object_carried(game);
+
+  if (player_take_object(game->player, object_get_id(game->object)) == ERROR)
+  {
+    return ERROR;
+  }
+  if (!carried)
+  {
+    game->hash ^= game_hash_key(HASH_CARRIED, NO_ID);
+  }
+  /* The object carried is always where the player is */
+  game_set_object_location(game, game_get_player_location(game));
+
+  return OK;
+}
+
+/**
+* @brief drops the object
+*
+* game_drop_object makes the player leave the object and, once
+* it does, updates the hash of the state
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return the status
+*/
+STATUS game_drop_object(Game *game)
+{
+  BOOL carried = game_get_object_carried(game);
+
+  if (player_drop_object(game->player) == ERROR)
+  {
+    return ERROR;
+  }
+  if (carried)
+  {
+    game->hash ^= game_hash_key(HASH_CARRIED, NO_ID);
+  }
+
+  return OK;
+}
+
+/**
+* @brief gets the location
+*
+* game_get_player_location gets the location of the player
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @return the id of the location
+*/
+Id game_get_player_location(Game *game)
+{
+  return player_get_location(game->player);
+}
+
+/**
+* @brief gets the location
+*
+* game_get_object_location gets the location of the object
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @return the id of the location
+*/
+Id game_get_object_location(Game *game)
+{
+  return object_get_id(game->object);
+}
+
+/**
+* @brief tells if the object is carried
+*
+* game_get_object_carried tells if the player carries the object
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return TRUE if the player carries the object
+*/
+BOOL game_get_object_carried(Game *game)
+{
+  return player_object(game->player);
+}
+
+/**
+* @brief gets a snapshot of the game
+*
+* game_get_state copies the dynamic state of the game
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param state is where the state is copied
+*/
+void game_get_state(Game *game, Game_state *state)
+{
+  state->player_location = game_get_player_location(game);
+  state->object_location = game_get_object_location(game);
+  state->carried = game_get_object_carried(game);
+  state->last_cmd = game_get_last_command(game);
+  state->map_view = game->map_view;
+  state->scroll = game->scroll;
+}
+
+/**
+* @brief Computes the updating of the callbacks
+*
+* game_update updates the callbacks
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @param cmd is the command written in the terminal
+* @return the status
+*/
+STATUS game_update(Game *game, T_Command cmd)
+{
+  Command command;
+
+  command.cmd = cmd;
+  command.arg[0] = '\0';
+
+  return game_update_command(game, &command);
+}
+
+/**
+* @brief Computes the updating of the callbacks with an argument
+*
+* game_update_command runs the callback of the command passing its argument
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param command is the command and its argument
+* @return the status
+*/
+STATUS game_update_command(Game *game, const Command *command)
+{
+  Id player = NO_ID, object = NO_ID;
+  BOOL carried = FALSE;
+
+  if (!command || command->cmd <= NO_CMD || command->cmd >= N_CALLBACK)
+    return ERROR;
+
+  player = game_get_player_location(game);
+  object = game_get_object_location(game);
+  carried = game_get_object_carried(game);
+
+  game->last_cmd = command->cmd;
+  (*game_callback_fn_list[command->cmd])(game, command->arg);
+  if (command->cmd != UNDO && command->cmd != REDO)
+    game_record(game, player, object, carried);
+  if (command->cmd != EXIT)
+  {
+    game->sequence++;
+    if (game->journal)
+      journal_append(game->journal, command, game_get_hash(game));
+  }
+  return OK;
+}
+
+/**
+* @brief Computes the updating of a sequence of commands
+*
+* game_update_many applies the commands in order. Runs of the same
+* move are applied as one repeated move of at most GAME_MAX_REPEAT,
+* so the journal replays them the same way, and the sequence stops at
+* the first move blocked by a missing link
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param cmds is the sequence of commands
+* @param n is the number of commands
+* @return the number of commands applied
+*/
+size_t game_update_many(Game *game, const T_Command *cmds, size_t n)
+{
+  size_t i = 0, run = 0;
+  long moved = 0;
+  Command command;
+  Id player = NO_ID, object = NO_ID;
+  BOOL carried = FALSE;
+
+  if (!game || !cmds)
+    return 0;
+
+  while (i < n)
+  {
+    if (cmds[i] == NEXT || cmds[i] == BACK)
+    {
+      for (run = 1; i + run < n && run < (size_t)GAME_MAX_REPEAT && cmds[i + run] == cmds[i]; run++)
+        ;
+      game->last_cmd = cmds[i];
+      player = game_get_player_location(game);
+      object = game_get_object_location(game);
+      carried = game_get_object_carried(game);
+      moved = game_move(game, cmds[i] == NEXT ? S : N, (long)run);
+      game_record(game, player, object, carried); /* The run is undone at once */
+      if (moved > 0)
+      {
+        game->sequence++; /* And recorded as a single move with a count */
+        if (game->journal)
+        {
+          command.cmd = cmds[i];
+          sprintf(command.arg, "%ld", moved);
+          journal_append(game->journal, &command, game_get_hash(game));
+        }
+      }
+      i += moved;
+      if ((size_t)moved < run)
+        return i;
+    }
+    else if (game_update(game, cmds[i]) == OK)
+    {
+      i++;
+    }
+    else
+    {
+      return i;
+    }
+  }
+
+  return i;
+}
+
+/**
+* @brief Computes the last command written
+*
+* game_get_last_command gets the last command written
+*
+* @date 08/02/2019
+* @author David Ramirez
+* @param game is the game
+* @return the command written
+*/
+T_Command game_get_last_command(Game *game)
+{
+  return game->last_cmd;
+}
+
+/**
+* @brief gets the layout of the map
+*
+* game_get_map_grid gets the index of the positions of the spaces
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return the grid of the map
+*/
+Map_grid *game_get_map_grid(Game *game)
+{
+  return world_get_map_grid(game->world);
+}
+
+/**
+* @brief gets the world
+*
+* game_get_world gets the board the game is played on, to create
+* more games on it
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return the world
+*/
+World *game_get_world(Game *game)
+{
+  return game->world;
+}
+
+/**
+* @brief sets the journal
+*
+* game_set_journal makes every command applied from now on be
+* recorded in a journal, or stops recording if it is NULL
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param journal is the journal
+*/
+void game_set_journal(Game *game, Journal *journal)
+{
+  game->journal = journal;
+}
+
+/**
+* @brief gets the position in the journal
+*
+* game_get_sequence gets the number of commands the journal of the game
+* holds up to its state, counted even if there is no journal, so a
+* snapshot knows which commands of the journal it already has
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return the number of commands
+*/
+unsigned long game_get_sequence(Game *game)
+{
+  return game->sequence;
+}
+
+/**
+* @brief gets the hash of the state
+*
+* game_get_hash gets a hash of the player location, the object
+* location and whether it is carried. It is the xor of one random
+* key per part, so equal states always have the same hash, and the
+* setters keep it up to date by xoring out the old key and in the new one
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return the hash of the state
+*/
+unsigned long game_get_hash(Game *game)
+{
+#ifdef DEBUG
+  if (game->hash != game_compute_hash(game))
+    fprintf(stderr, "The hash of the state is out of date\n");
+#endif
+  return game->hash;
+}
+
+/**
+* @brief saves the state of the game
+*
+* game_save writes a snapshot of the dynamic state: the locations,
+* whether the object is carried, the last command, the view and how
+* many commands of the journal it has. The world is not in it, only a fingerprint to check it is loaded on the
+* same one. It is written to a temporary file renamed at the end, so a
+* crash never leaves half a snapshot, and it does not allocate memory,
+* so it can be called in a child process after a fork
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param path is the file of the snapshot
+* @return the status
+*/
+STATUS game_save(Game *game, const char *path)
+{
+  unsigned char buf[SNAPSHOT_SIZE];
+  char tmp[WORD_SIZE];
+  size_t done = 0;
+  ssize_t n = 0;
+  int fd = -1;
+
+  if (!game || !path || strlen(path) + sizeof(".tmp") > sizeof(tmp))
+    return ERROR;
+
+  game_snapshot_encode(game, buf);
+
+  strcpy(tmp, path);
+  strcat(tmp, ".tmp");
+  if ((fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1)
+    return ERROR;
+
+  while (done < sizeof(buf))
+  {
+    if ((n = write(fd, buf + done, sizeof(buf) - done)) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    done += n;
+  }
+
+  if (done < sizeof(buf) || fsync(fd) == -1)
+  {
+    close(fd);
+    unlink(tmp);
+    return ERROR;
+  }
+  close(fd);
+
+  return rename(tmp, path) == 0 ? OK : ERROR;
+}
+
+/**
+* @brief loads the state of the game
+*
+* game_load maps a snapshot written by game_save and sets the state
+* of a game created from the same world. Nothing is changed if the
+* snapshot is not valid. The history of changes starts empty
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game, already created from its world
+* @param path is the file of the snapshot
+* @return ERROR if the snapshot can not be read, is of another
+* version or world, or is damaged
+*/
+STATUS game_load(Game *game, const char *path)
+{
+  const unsigned char *buf = NULL;
+  struct stat st;
+  int fd = -1;
+  STATUS status = ERROR;
+
+  if (!game || !path || (fd = open(path, O_RDONLY)) == -1)
+    return ERROR;
+
+  if (fstat(fd, &st) == -1 || st.st_size != SNAPSHOT_SIZE ||
+      (buf = (const unsigned char *)mmap(NULL, SNAPSHOT_SIZE, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+  {
+    close(fd);
+    return ERROR;
+  }
+  close(fd);
+
+  if ((status = game_snapshot_decode(game, buf)) == OK)
+  {
+    game->history_top = 0;
+    game->undo_count = game->redo_count = 0;
+  }
+
+  munmap((void *)buf, SNAPSHOT_SIZE);
+  return status;
+}
+
+/**
+* @brief encodes the whole state of the game
+*
+* game_encode writes the state of a snapshot followed by the changes
+* that can be undone and redone, so a game can be put aside and
+* decoded later as it was. Only the changes kept are written, so a
+* game that has not changed takes a few bytes
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param buf is where the state is written
+* @param size is the size of the buffer, GAME_ENCODED_MAX is always enough
+* @return the number of bytes written, or 0 if they do not fit
+*/
+size_t game_encode(Game *game, unsigned char *buf, size_t size)
+{
+  unsigned char *at = NULL;
+  int n = 0, i = 0, slot = 0;
+
+  if (!game || !buf)
+    return 0;
+  n = game->undo_count + game->redo_count;
+  if (size < ENCODED_HISTORY_AT + (size_t)n * ENCODED_DELTA_SIZE)
+    return 0;
+
+  game_snapshot_encode(game, buf);
+  game_put_number(buf + ENCODED_UNDO_AT, (unsigned long)game->undo_count, 2);
+  game_put_number(buf + ENCODED_REDO_AT, (unsigned long)game->redo_count, 2);
+
+  slot = (game->history_top - game->undo_count) & (GAME_HISTORY - 1);
+  for (i = 0, at = buf + ENCODED_HISTORY_AT; i < n; i++, at += ENCODED_DELTA_SIZE)
+  {
+    game_put_number(at, game->history[slot].player, 8);
+    game_put_number(at + 8, game->history[slot].object, 8);
+    at[16] = game->history[slot].carried ? 1 : 0;
+    slot = (slot + 1) & (GAME_HISTORY - 1);
+  }
+
+  return (size_t)(at - buf);
+}
+
+/**
+* @brief decodes the whole state of the game
+*
+* game_decode sets the state written by game_encode on a game created
+* from the same world. Nothing is changed if the state is not valid
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game, already created from its world
+* @param buf is the state
+* @param len is the number of bytes of the state
+* @return ERROR if the state is not valid or there is no memory
+*/
+STATUS game_decode(Game *game, const unsigned char *buf, size_t len)
+{
+  const unsigned char *at = NULL;
+  int undo = 0, redo = 0, i = 0;
+
+  if (!game || !buf || len < ENCODED_HISTORY_AT)
+    return ERROR;
+
+  undo = (int)game_get_number(buf + ENCODED_UNDO_AT, 2);
+  redo = (int)game_get_number(buf + ENCODED_REDO_AT, 2);
+  if (undo + redo > GAME_HISTORY || len != ENCODED_HISTORY_AT + (size_t)(undo + redo) * ENCODED_DELTA_SIZE)
+    return ERROR;
+  if (undo + redo > 0 && !game->history &&
+      !(game->history = (Game_delta *)malloc(GAME_HISTORY * sizeof(Game_delta))))
+    return ERROR;
+  if (game_snapshot_decode(game, buf) == ERROR)
+    return ERROR;
+
+  /* The oldest change kept goes to the first slot */
+  for (i = 0, at = buf + ENCODED_HISTORY_AT; i < undo + redo; i++, at += ENCODED_DELTA_SIZE)
+  {
+    game->history[i].player = game_get_number(at, 8);
+    game->history[i].object = game_get_number(at + 8, 8);
+    game->history[i].carried = at[16] ? TRUE : FALSE;
+  }
+  game->history_top = undo & (GAME_HISTORY - 1);
+  game->undo_count = undo;
+  game->redo_count = redo;
+
+  return OK;
+}
+
+/**
+* @brief writes the state of a snapshot
+*
+* game_snapshot_encode fills the SNAPSHOT_SIZE bytes of a snapshot
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param buf is where the snapshot is written
+*/
+void game_snapshot_encode(Game *game, unsigned char *buf)
+{
+  memset(buf, 0, SNAPSHOT_SIZE);
+  memcpy(buf, SNAPSHOT_MAGIC, 4);
+  game_put_number(buf + SNAPSHOT_VERSION_AT, SNAPSHOT_VERSION, 4);
+  game_put_number(buf + SNAPSHOT_WORLD_AT, game_world_fingerprint(game), 8);
+  game_put_number(buf + SNAPSHOT_PLAYER_AT, (unsigned long)game_get_player_location(game), 8);
+  game_put_number(buf + SNAPSHOT_OBJECT_AT, (unsigned long)game_get_object_location(game), 8);
+  buf[SNAPSHOT_CARRIED_AT] = game_get_object_carried(game) ? 1 : 0;
+  buf[SNAPSHOT_LAST_CMD_AT] = (unsigned char)(game->last_cmd + 1);
+  buf[SNAPSHOT_MAP_VIEW_AT] = game->map_view ? 1 : 0;
+  game_put_number(buf + SNAPSHOT_SCROLL_AT, (unsigned long)game->scroll, 4);
+  game_put_number(buf + SNAPSHOT_HASH_AT, game_get_hash(game), 8);
+  game_put_number(buf + SNAPSHOT_SEQUENCE_AT, game->sequence, 8);
+}
+
+/**
+* @brief reads the state of a snapshot
+*
+* game_snapshot_decode checks a snapshot and sets its state, leaving
+* the history as it is. Nothing is changed if it is not valid
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @param buf is the snapshot, SNAPSHOT_SIZE bytes
+* @return ERROR if it is of another version or world, or is damaged
+*/
+STATUS game_snapshot_decode(Game *game, const unsigned char *buf)
+{
+  Id player = NO_ID, object = NO_ID;
+  unsigned long hash = 0;
+  int last_cmd = 0;
+
+  player = (Id)game_get_number(buf + SNAPSHOT_PLAYER_AT, 8);
+  object = (Id)game_get_number(buf + SNAPSHOT_OBJECT_AT, 8);
+  last_cmd = (int)buf[SNAPSHOT_LAST_CMD_AT] - 1;
+
+  /* The hash of the values read must be the one saved */
+  hash = game_hash_key(HASH_PLAYER, player) ^ game_hash_key(HASH_OBJECT, object);
+  if (buf[SNAPSHOT_CARRIED_AT])
+    hash ^= game_hash_key(HASH_CARRIED, NO_ID);
+
+  if (memcmp(buf, SNAPSHOT_MAGIC, 4) ||
+      game_get_number(buf + SNAPSHOT_VERSION_AT, 4) != SNAPSHOT_VERSION ||
+      game_get_number(buf + SNAPSHOT_WORLD_AT, 8) != game_world_fingerprint(game) ||
+      game_get_number(buf + SNAPSHOT_HASH_AT, 8) != hash ||
+      last_cmd < NO_CMD || last_cmd >= N_COMMANDS)
+    return ERROR;
+
+  /* The hash only tells the bytes are the ones saved, not that they are
+     a state of this world: both must be on a space, and the object
+     carried where the player is */
+  if (game_get_space(game, player) == NULL || game_get_space(game, object) == NULL ||
+      (buf[SNAPSHOT_CARRIED_AT] && object != player))
+    return ERROR;
+
+  game_set_player_location(game, player);
+  game_set_object_location(game, object);
+  if (buf[SNAPSHOT_CARRIED_AT])
+    game_take_object(game);
+  else
+    game_drop_object(game);
+  game->last_cmd = (T_Command)last_cmd;
+  game->map_view = buf[SNAPSHOT_MAP_VIEW_AT] ? TRUE : FALSE;
+  game->scroll = (int)game_get_number(buf + SNAPSHOT_SCROLL_AT, 4);
+  if (game->scroll < 0 || game->scroll > GAME_MAX_SCROLL)
+    game->scroll = 0;
+  game->sequence = game_get_number(buf + SNAPSHOT_SEQUENCE_AT, 8);
+
+  return OK;
+}
+
+/**
+* @brief computes the hash of the state
+*
+* game_compute_hash computes the hash of the state from scratch
+*
+* @date 19/10/2026
+* @author David Ramirez
+* @param game is the game
+* @return the hash of the state
+*/
+unsigned long game_compute_hash(Game *game)
+{
+  unsigned long hash = 0;
+
+  hash ^= game_hash_key(HASH_PLAYER, game_get_player_location(game));
+  hash ^= game_hash_key(HASH_OBJECT, game_get_object_location(game));
+  if (game_get_object_carried(game))
+    hash ^= game_hash_key(HASH_CARRIED, NO_ID);
+
+  return hash;
+}
+
+#ifndef OCA_LIBRARY
+/**
+* @brief Prints the information we want to know
+*
+* game_print_data prints the location of the object and the player
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game
+*/
+void game_print_data(Game *game)
+{
+  int i = 0;
+
+  printf("\n\n-------------\n\n");
+
+  printf("=> Spaces: \n");
+  for (i = 0; i < world_get_n_spaces(game->world); i++)
+  {
+    space_print(world_get_space_at(game->world, i));
+  }
+
+  printf("=> Object location: %ld\n", object_get_id(game->object));
+  printf("=> Player location: %ld\n", player_get_id(game->player));
+  printf("prompt:> ");
+}
+#endif
+
+/**
+* @brief when the game ends
+*
+* game_is_over used when the game ends
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game is the game
+* @return FALSE
+*/
+BOOL game_is_over(Game *game)
+{
+  return FALSE;
+}
+
+/**
+   Callbacks implementation for each action 
+*/
+
+/**
+* @brief when there is and unknown command, it does not do anything
+*
+* game_callback_unknown used if something unknown is written with the keyboard
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_unknown(Game *game, const char *arg)
+{
+}
+
+/**
+* @brief when write e with the keyboard, exit the game
+*
+* game_callback_exit used to go exit the game
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_exit(Game *game, const char *arg)
+{
+}
+
+/**
+* @brief when write n with the keyboard, go to the next space in the game
+*
+* game_callback_next used to go to the next space, as many times as
+* the count given
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the number of spaces, one if it is empty
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_next(Game *game, const char *arg)
+{
+  game_move(game, S, game_repeat_count(arg));
+}
+
+/**
+* @brief when write b with the keyboard, go a space back in the game
+*
+* game_callback_back used to go to the back space, as many times as
+* the count given
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the number of spaces, one if it is empty
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_back(Game *game, const char *arg)
+{
+  game_move(game, N, game_repeat_count(arg));
+}
+
+/**
+* @brief when write t with the keyboard, take the object
+*
+* game_callback_take takes the object
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game is the game where we want to take an object
+* @param arg is the name of the object, it can be empty
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_take(Game *game, const char *arg)
+{
+  const char *name = object_get_name(game->object);
+
+  /* A name given must be the one of the object, if it has one */
+  if (*arg && name && *name && strcasecmp(arg, name))
+    return;
+
+  game_take_object(game);
+}
+
+/**
+* @brief when write d with the keyboard, drops the object
+*
+* game_callback_drop drops the object
+*
+* @date 12/02/2019
+* @author David Ramirez
+*
+* @param game is the game where we want to drop an object
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_drop(Game *game, const char *arg)
+{
+  game_drop_object(game);
+}
+
+/**
+* @brief when write m with the keyboard, shows or hides the whole map
+*
+* game_callback_map switches between the map around the player and
+* the view of the whole map
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_map(Game *game, const char *arg)
+{
+  game->map_view = !game->map_view;
+}
+
+/**
+* @brief when write k with the keyboard, shows an older feedback line
+*
+* game_callback_up scrolls the feedback one line back
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_up(Game *game, const char *arg)
+{
+  if (game->scroll < GAME_MAX_SCROLL)
+    game->scroll++;
+}
+
+/**
+* @brief when write j with the keyboard, shows a newer feedback line
+*
+* game_callback_down scrolls the feedback one line forward
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_down(Game *game, const char *arg)
+{
+  if (game->scroll > 0)
+    game->scroll--;
+}
+
+/**
+* @brief when write g and a space with the keyboard, go to that space
+*
+* game_callback_goto moves the player, and the object if it is carried,
+* straight to the space given
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the id of the space
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_goto(Game *game, const char *arg)
+{
+  Id space_id = atol(arg);
+
+  if (game_get_space(game, space_id) == NULL)
+  {
+    return;
+  }
+
+  game_set_player_location(game, space_id);
+  if (player_object(game->player) == TRUE)
+  {
+    game_set_object_location(game, space_id);
+  }
+}
+
+/**
+* @brief when write z with the keyboard, undoes the last change
+*
+* game_callback_undo reverts the last change of the locations or of
+* the object carried that has not been undone yet
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_undo(Game *game, const char *arg)
+{
+  if (game->undo_count == 0)
+  {
+    return;
+  }
+
+  game->history_top = (game->history_top - 1) & (GAME_HISTORY - 1);
+  game_apply_delta(game, &game->history[game->history_top]);
+  game->undo_count--;
+  game->redo_count++;
+}
+
+/**
+* @brief when write y with the keyboard, redoes the last change undone
+*
+* game_callback_redo applies again the last change undone, as long as
+* nothing else has changed since
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param arg is the argument of the command, it is not used
+* @return it doesn't return anything because it's type void
+*/
+void game_callback_redo(Game *game, const char *arg)
+{
+  if (game->redo_count == 0)
+  {
+    return;
+  }
+
+  game_apply_delta(game, &game->history[game->history_top]);
+  game->history_top = (game->history_top + 1) & (GAME_HISTORY - 1);
+  game->redo_count--;
+  game->undo_count++;
+}
+
+/**
+* @brief moves the player following the links
+*
+* game_move moves the player, and the object if it is carried, along
+* the links of a direction until the count is reached or there is no
+* link. The object is only moved once, at the end
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param direction is N to go back or S to go to the next space
+* @param count is the number of spaces
+* @return the number of spaces moved
+*/
+long game_move(Game *game, DIRECTION direction, long count)
+{
+  Space *space = NULL, *next = NULL;
+  long moved = 0;
+
+  if (!(space = game_get_space(game, game_get_player_location(game))))
+  {
+    return 0;
+  }
+
+  for (moved = 0; moved < count; moved++)
+  {
+    next = game_get_space(game, direction == S ? space_get_south(space) : space_get_north(space));
+    if (next == NULL)
+    {
+      break;
+    }
+    space = next;
+  }
+
+  if (moved > 0)
+  {
+    game_set_player_location(game, space_get_id(space));
+    if (player_object(game->player) == TRUE)
+    {
+      game_set_object_location(game, space_get_id(space));
+    }
+  }
+
+  return moved;
+}
+
+/**
+* @brief reads the count of a repeated command
+*
+* game_repeat_count parses the argument of a move
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param arg is the argument
+* @return the count, one if it is empty or not valid
+*/
+long game_repeat_count(const char *arg)
+{
+  long count = atol(arg);
+
+  if (count < 1)
+    return 1;
+  if (count > GAME_MAX_REPEAT)
+    return GAME_MAX_REPEAT;
+
+  return count;
+}
+
+/**
+* @brief gets the key of a part of the state
+*
+* game_hash_key mixes a role and an id into a random looking
+* 64 bit key, the same in every run and on every machine
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param role is what the id is
+* @param id is the id
+* @return the key
+*/
+unsigned long game_hash_key(int role, Id id)
+{
+  unsigned long key = ((unsigned long)id << 2) ^ (unsigned long)role;
+
+  /* The finalizer of splitmix64 */
+  key += 0x9e3779b97f4a7c15UL;
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9UL;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebUL;
+  return key ^ (key >> 31);
+}
+
+/**
+* @brief records what a command changed
+*
+* game_record adds the delta from the state given to the current one
+* to the history, if something changed. The oldest change is forgotten
+* when the history is full, and the changes undone can not be redone
+* any more
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param player is the location of the player before the command
+* @param object is the location of the object before the command
+* @param carried is whether the object was carried before the command
+*/
+void game_record(Game *game, Id player, Id object, BOOL carried)
+{
+  Game_delta delta;
+
+  delta.player = (unsigned long)player ^ (unsigned long)game_get_player_location(game);
+  delta.object = (unsigned long)object ^ (unsigned long)game_get_object_location(game);
+  delta.carried = (carried != game_get_object_carried(game)) ? TRUE : FALSE;
+  if (!delta.player && !delta.object && !delta.carried)
+  {
+    return;
+  }
+
+  /* Most games never change, so they do not pay for the history */
+  if (!game->history && !(game->history = (Game_delta *)malloc(GAME_HISTORY * sizeof(Game_delta))))
+  {
+    return;
+  }
+  game->history[game->history_top] = delta;
+
+  game->history_top = (game->history_top + 1) & (GAME_HISTORY - 1);
+  if (game->undo_count < GAME_HISTORY)
+  {
+    game->undo_count++;
+  }
+  game->redo_count = 0;
+}
+
+/**
+* @brief applies a change
+*
+* game_apply_delta flips the state between the one before and the
+* one after a change, in both directions
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param delta is the change
+*/
+void game_apply_delta(Game *game, const Game_delta *delta)
+{
+  if (delta->player)
+  {
+    game_set_player_location(game, (Id)((unsigned long)game_get_player_location(game) ^ delta->player));
+  }
+  if (delta->object)
+  {
+    game_set_object_location(game, (Id)((unsigned long)game_get_object_location(game) ^ delta->object));
+  }
+  if (delta->carried)
+  {
+    if (game_get_object_carried(game))
+    {
+      game_drop_object(game);
+    }
+    else
+    {
+      game_take_object(game);
+    }
+  }
+}
+
+/**
+* @brief computes the fingerprint of the world
+*
+* game_world_fingerprint mixes the id and the links of every space,
+* so a snapshot is only loaded on the world it was saved from
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @return the fingerprint
+*/
+unsigned long game_world_fingerprint(Game *game)
+{
+  Space *space = NULL;
+  unsigned long fingerprint = 0;
+  int i = 0;
+
+  for (i = 0; (space = world_get_space_at(game->world, i)) != NULL; i++)
+  {
+    fingerprint = game_hash_key(i, space_get_id(space) ^ (Id)fingerprint);
+    fingerprint ^= game_hash_key(N, space_get_north(space));
+    fingerprint ^= game_hash_key(S, space_get_south(space));
+    fingerprint ^= game_hash_key(E, space_get_east(space));
+    fingerprint ^= game_hash_key(W, space_get_west(space));
+  }
+
+  return fingerprint;
+}
+
+/**
+* @brief writes a number
+*
+* game_put_number writes the lowest bytes of a number, lowest first
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is where it is written
+* @param value is the number
+* @param len is the number of bytes
+*/
+void game_put_number(unsigned char *buf, unsigned long value, int len)
+{
+  int i = 0;
+
+  for (i = 0; i < len; i++, value >>= 8)
+    buf[i] = (unsigned char)(value & 0xff);
+}
+
+/**
+* @brief reads a number
+*
+* game_get_number reads a number written by game_put_number
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is where it is read
+* @param len is the number of bytes
+* @return the number
+*/
+unsigned long game_get_number(const unsigned char *buf, int len)
+{
+  unsigned long value = 0;
+
+  while (len-- > 0)
+    value = (value << 8) | buf[len];
+
+  return value;
+}
@@ -1,44 +1,109 @@
-/** 
- * @brief It implements the game interface and all the associated callbacks
- * for each command
- * 
- * @file game.c
- * @author David Ramirez
- * @version 1.0 
- * @date 09/01/2019 
- */
-
-#ifndef GAME_H
-#define GAME_H
-
-#include "command.h"
-#include "space.h"
-#include "player.h"
-#include "object.h"
-
-typedef struct _Game
-{
-  Player *player;
-  Object *object;
-  Space *spaces[MAX_SPACES + 1];
-  T_Command last_cmd;
-} Game;
-
-STATUS game_create_from_file(Game *game, char *filename);
-STATUS game_create(Game *game);
-STATUS game_update(Game *game, T_Command cmd);
-STATUS game_destroy(Game *game);
-BOOL game_is_over(Game *game);
-void game_print_screen(Game *game);
-void game_print_data(Game *game);
-Space *game_get_space(Game *game, Id id);
-Id game_get_player_location(Game *game);
-Id game_get_object_location(Game *game);
-T_Command game_get_last_command(Game *game);
-/*****************************************************/
-STATUS game_add_space(Game *game, Space *space);
-Id game_get_space_id_at(Game *game, int position);
-STATUS game_set_player_location(Game *game, Id id);
-STATUS game_set_object_location(Game *game, Id id);
-/*****************************************************/
-#endif
+/** 
+ * @brief It implements the game interface and all the associated callbacks
+ * for each command
+ * 
+ * @file game.c
+ * @author David Ramirez
+ * @version 1.0 
+ * @date 09/01/2019 
+ */
+
+#ifndef GAME_H
+#define GAME_H
+
+#include "command.h"
+#include "space.h"
+#include "player.h"
+#include "object.h"
+#include "map_grid.h"
+#include "journal.h"
+#include "world.h"
+
+#define GAME_MAX_SCROLL 100
+#define GAME_MAX_REPEAT 1000000L /* Largest count of a repeated move */
+#define GAME_HISTORY 256         /* Power of two, moves that can be undone */
+#define GAME_ENCODED_MAX (64 + GAME_HISTORY * 17) /* Longest state written by game_encode */
+
+/**
+ * @brief What a command changed
+ *
+ * Every field is the xor of the value before and after the command,
+ * so applying the same delta again undoes it, and once more redoes it
+ */
+typedef struct _Game_delta
+{
+  unsigned long player; /*!< Change of the location of the player */
+  unsigned long object; /*!< Change of the location of the object */
+  BOOL carried;         /*!< Whether the object was taken or dropped */
+} Game_delta;
+
+/*
+ * The board is shared by every game played on it, a game only
+ * owns the positions and what it needs to undo them
+ */
+typedef struct _Game
+{
+  World *world; /* The spaces, shared and never changed */
+  Player *player;
+  Object *object;
+  T_Command last_cmd;
+  BOOL map_view;
+  int scroll;
+  Journal *journal; /* Where the commands applied are recorded, if any */
+  unsigned long sequence; /* Commands of the journal up to this state */
+  unsigned long hash; /* Hash of the state, kept up to date by the setters */
+  Game_delta *history; /* Ring of the last changes, allocated with the first one */
+  int history_top;     /* Slot of the next change */
+  int undo_count, redo_count; /* Changes that can be undone and redone */
+} Game;
+
+/**
+ * @brief A copy of the dynamic part of a game
+ *
+ * It is what the graphic engine needs to paint a frame, so it
+ * can be handed to another thread while the game keeps changing
+ */
+typedef struct _Game_state
+{
+  Id player_location; /*!< Space where the player is */
+  Id object_location; /*!< Space where the object is */
+  BOOL carried;       /*!< Whether the player carries the object */
+  T_Command last_cmd; /*!< Last command applied */
+  BOOL map_view;      /*!< Whether the whole map is shown */
+  int scroll;         /*!< Feedback lines scrolled back */
+} Game_state;
+
+STATUS game_create_from_file(Game *game, char *filename);
+STATUS game_create_from_world(Game *game, World *world);
+STATUS game_create(Game *game);
+STATUS game_update(Game *game, T_Command cmd);
+STATUS game_update_command(Game *game, const Command *command);
+size_t game_update_many(Game *game, const T_Command *cmds, size_t n);
+STATUS game_destroy(Game *game);
+BOOL game_is_over(Game *game);
+void game_print_screen(Game *game);
+void game_print_data(Game *game);
+Space *game_get_space(Game *game, Id id);
+Id game_get_player_location(Game *game);
+Id game_get_object_location(Game *game);
+BOOL game_get_object_carried(Game *game);
+void game_get_state(Game *game, Game_state *state);
+T_Command game_get_last_command(Game *game);
+Map_grid *game_get_map_grid(Game *game);
+World *game_get_world(Game *game);
+void game_set_journal(Game *game, Journal *journal);
+unsigned long game_get_sequence(Game *game);
+unsigned long game_get_hash(Game *game);
+STATUS game_save(Game *game, const char *path);
+STATUS game_load(Game *game, const char *path);
+size_t game_encode(Game *game, unsigned char *buf, size_t size);
+STATUS game_decode(Game *game, const unsigned char *buf, size_t len);
+unsigned long game_world_fingerprint(Game *game);
+/*****************************************************/
+Id game_get_space_id_at(Game *game, int position);
+STATUS game_set_player_location(Game *game, Id id);
+STATUS game_set_object_location(Game *game, Id id);
+STATUS game_take_object(Game *game);
+STATUS game_drop_object(Game *game);
+/*****************************************************/
+#endif
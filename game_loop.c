@@ -1,52 +1,895 @@
-/** 
- * @brief It defines the game loop 
- * 
- * @file game_loop.c
- * @author David Ramirez
- * @version 1.0 
- * @date 12/02/2019 
- * @copyright GNU Public License
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include "graphic_engine.h"
-#include "game_reader.h"
-
-int main(int argc, char *argv[])
-{
-	Game game;
-	T_Command command = NO_CMD;
-	Graphic_engine *gengine;
-
-	/*Check the number of arguments*/
-	if (argc < 2)
-	{
-		fprintf(stderr, "Use: %s <game_data_file>\n", argv[0]);
-		return 1;
-	}
-	/*Creates the game from the file loaded in argv[1]*/
-	if (game_create_from_file(&game, argv[1]) == ERROR)
-	{
-		fprintf(stderr, "Error while initializing game.\n");
-		return 1;
-	}
-	/*Creates the graphic engine */
-	if ((gengine = graphic_engine_create()) == NULL)
-	{
-		fprintf(stderr, "Error while initializing graphic engine.\n");
-		game_destroy(&game); /*Deletes the dynamic memory*/
-		return 1;
-	}
-
-	while ((command != EXIT) && !game_is_over(&game))
-	{
-		graphic_engine_paint_game(gengine, &game); /*Paints the game*/
-		command = get_user_input();				   /*Reads the commands from the keyboard*/
-		game_update(&game, command);			   /*Upgrades the game*/
-	}
-
-	game_destroy(&game);			 /*Frees the memory*/
-	graphic_engine_destroy(gengine); /*Frees the memory*/
-	return 0;
-}
+/**
+ * @brief It defines the game loop
+ *
+ * The loop is split in three threads: the input thread reads the
+ * commands and queues them, the main thread applies them to the game
+ * and publishes a snapshot after each one, and the render thread
+ * paints the latest snapshot at most once per frame interval.
+ *
+ * With --raw the terminal is put in raw mode and every key is a command,
+ * without waiting for Enter. The input thread polls the keyboard with a
+ * timeout, so it notices when the game finishes and ends by itself.
+ *
+ * With --script the commands are read from a file instead and applied
+ * without painting, to run regression and load tests. The commands
+ * without an argument are applied in a row with game_update_many, so a
+ * run of the same move is recorded as a single move with a count.
+ *
+ * With --journal every command applied is recorded in a file, and the
+ * commands already in it are replayed first, so a session that died
+ * goes on where it was. A snapshot knows how many commands of the
+ * journal it has, so with --load only the ones after it are replayed.
+ *
+ * With --load the state of a snapshot is set on the world before
+ * anything else, and with --save a snapshot is written at the end.
+ * With --autosave a snapshot is written periodically by a forked child,
+ * so the game does not stop while it is written.
+ *
+ * The main thread keeps its timers in a timer wheel, and waits for the
+ * commands only until the next one expires. With --turn-ms the turn is
+ * played for the player, who moves to the next space, if no command
+ * comes in time, and with --idle-ms the game ends when no command comes
+ * for that long. The autosave is checked by a timer too while there is
+ * no input.
+ *
+ * @file game_loop.c
+ * @author David Ramirez
+ * @version 1.1
+ * @date 19/10/2026
+ * @copyright GNU Public License
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include "graphic_engine.h"
+#include "game_reader.h"
+#include "spsc_queue.h"
+#include "autosave.h"
+#include "timer_wheel.h"
+
+#define FRAME_INTERVAL_NS 16666666L /* Around 60 frames per second */
+#define INPUT_POLL_MS 50            /* How often the input thread checks if the game finished */
+#define IDLE_TICK_S 1               /* How often the autosave is checked while there is no input */
+#define SCRIPT_TICK 1024            /* Commands of a script applied in a row, and between two autosave checks */
+
+extern const char *const cmd_to_str[];
+
+/**
+ * @brief The state shared by the threads of the loop
+ */
+typedef struct _Loop
+{
+	Game game;				  /*!< The game, only touched by the main thread */
+	Graphic_engine *gengine;  /*!< The engine, only touched by the render thread */
+	Graphic_feedback feedback; /*!< Commands shown, only touched by the render thread */
+	Spsc_queue *commands;	  /*!< Commands from the input thread */
+	Autosave *autosave;		  /*!< Autosave of the game, or NULL */
+	Command_reader *reader;	  /*!< Reader of the keyboard, only touched by the input thread */
+	BOOL raw;				  /*!< Whether the terminal is in raw mode */
+	struct termios saved;	  /*!< Terminal settings to restore after raw mode */
+	sem_t pending;			  /*!< Number of commands waiting in the queue */
+	pthread_mutex_t lock;	  /*!< Protects the snapshot and the flags below */
+	pthread_cond_t published; /*!< Signaled when a snapshot is published */
+	Game_state snapshot;	  /*!< Latest published state */
+	unsigned long seq;		  /*!< Number of published snapshots */
+	BOOL done;				  /*!< Whether the game has finished */
+	Timer_wheel *timers;	  /*!< Timers of the main thread, in milliseconds */
+	Timer turn;				  /*!< Plays the turn when no command comes in time */
+	Timer idle;				  /*!< Ends the game when no command comes for long */
+	Timer tick;				  /*!< Checks the autosave while there is no input */
+	long turn_ms;			  /*!< Time for a turn, 0 for no limit */
+	long idle_ms;			  /*!< Time without commands before the game ends, 0 for never */
+	unsigned long timed_turns; /*!< Turns played by the turn timer */
+	BOOL kicked;			  /*!< Whether the game ended for being idle */
+} Loop;
+
+void *game_loop_input(void *arg);
+void *game_loop_render(void *arg);
+void game_loop_paint(Graphic_engine *gengine, Game *game, const Game_state *state, Graphic_feedback *feedback);
+void game_loop_publish(Loop *loop, BOOL finish);
+BOOL game_loop_is_done(Loop *loop);
+STATUS game_loop_raw_begin(Loop *loop);
+void game_loop_raw_end(Loop *loop);
+int game_loop_interactive(Loop *loop);
+int game_loop_script(Game *game, const char *script, BOOL render_final, Autosave *autosave);
+void game_loop_script_apply(Game *game, const T_Command *cmds, size_t n);
+STATUS game_loop_replay(void *data, const Command *command);
+STATUS game_loop_wait(Loop *loop);
+void game_loop_start_timers(Loop *loop);
+void game_loop_on_turn(void *context, void *data);
+void game_loop_on_idle(void *context, void *data);
+void game_loop_on_tick(void *context, void *data);
+unsigned long game_loop_now_ms();
+void game_loop_print_autosave(Autosave *autosave);
+
+int main(int argc, char *argv[])
+{
+	Loop loop;
+	Journal *journal = NULL;
+	char *script = NULL, *journal_path = NULL, *load_path = NULL, *save_path = NULL;
+	char *autosave_prefix = NULL;
+	long autosave_ms = AUTOSAVE_INTERVAL_MS;
+	int autosave_keep = AUTOSAVE_RETENTION;
+	BOOL render_final = FALSE;
+	long fsync_ms = JOURNAL_FSYNC_MS;
+	unsigned long replayed = 0;
+	int i = 0, status = 0;
+
+	loop.raw = FALSE;
+	loop.autosave = NULL;
+	loop.turn_ms = 0;
+	loop.idle_ms = 0;
+
+	/*Check the number of arguments*/
+	for (i = 2; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--script") && i + 1 < argc)
+			script = argv[++i];
+		else if (!strcmp(argv[i], "--render-final"))
+			render_final = TRUE;
+		else if (!strcmp(argv[i], "--raw"))
+			loop.raw = TRUE;
+		else if (!strcmp(argv[i], "--journal") && i + 1 < argc)
+			journal_path = argv[++i];
+		else if (!strcmp(argv[i], "--fsync-ms") && i + 1 < argc)
+			fsync_ms = atol(argv[++i]);
+		else if (!strcmp(argv[i], "--load") && i + 1 < argc)
+			load_path = argv[++i];
+		else if (!strcmp(argv[i], "--save") && i + 1 < argc)
+			save_path = argv[++i];
+		else if (!strcmp(argv[i], "--autosave") && i + 1 < argc)
+			autosave_prefix = argv[++i];
+		else if (!strcmp(argv[i], "--autosave-ms") && i + 1 < argc)
+			autosave_ms = atol(argv[++i]);
+		else if (!strcmp(argv[i], "--autosave-keep") && i + 1 < argc)
+			autosave_keep = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--turn-ms") && i + 1 < argc)
+			loop.turn_ms = atol(argv[++i]);
+		else if (!strcmp(argv[i], "--idle-ms") && i + 1 < argc)
+			loop.idle_ms = atol(argv[++i]);
+		else
+			break;
+	}
+	if (argc < 2 || i < argc)
+	{
+		fprintf(stderr, "Use: %s <game_data_file> [--raw | --script <file|-> [--render-final]]\n"
+						"       [--journal <file> [--fsync-ms <ms>]] [--load <snapshot>] [--save <snapshot>]\n"
+						"       [--autosave <prefix> [--autosave-ms <ms>] [--autosave-keep <n>]]\n"
+						"       [--turn-ms <ms>] [--idle-ms <ms>]\n",
+				argv[0]);
+		return 1;
+	}
+	/*Creates the game from the file loaded in argv[1]*/
+	if (game_create_from_file(&loop.game, argv[1]) == ERROR)
+	{
+		fprintf(stderr, "Error while initializing game.\n");
+		return 1;
+	}
+
+	/*Resumes the snapshot*/
+	if (load_path && game_load(&loop.game, load_path) == ERROR)
+	{
+		fprintf(stderr, "Error while loading the snapshot %s.\n", load_path);
+		game_destroy(&loop.game);
+		return 1;
+	}
+
+	/*Recovers the session and records it from there*/
+	if (journal_path)
+	{
+		/*The commands a snapshot already has are not applied again*/
+		if (journal_replay(journal_path, game_get_sequence(&loop.game), game_loop_replay, NULL, &loop.game,
+						   &replayed) == ERROR)
+		{
+			fprintf(stderr, "Error while replaying the journal %s%s.\n", journal_path,
+					load_path ? ", it may not reach the snapshot" : "");
+			game_destroy(&loop.game);
+			return 1;
+		}
+		if ((journal = journal_open(journal_path, fsync_ms)) == NULL)
+		{
+			fprintf(stderr, "Error while opening the journal %s.\n", journal_path);
+			game_destroy(&loop.game);
+			return 1;
+		}
+		game_set_journal(&loop.game, journal);
+	}
+
+	if (autosave_prefix && !(loop.autosave = autosave_create(autosave_prefix, autosave_ms, autosave_keep)))
+	{
+		fprintf(stderr, "Error while initializing the autosave %s.\n", autosave_prefix);
+		if (journal)
+			journal_close(journal);
+		game_destroy(&loop.game);
+		return 1;
+	}
+
+	if (script)
+		status = game_loop_script(&loop.game, script, render_final, loop.autosave);
+	else
+		status = game_loop_interactive(&loop);
+
+	if (loop.autosave)
+	{
+		game_loop_print_autosave(loop.autosave);
+		autosave_destroy(loop.autosave);
+	}
+
+	if (journal)
+		journal_checkpoint(journal, game_get_hash(&loop.game)); /*Where the session ends*/
+	if (journal && journal_close(journal) == ERROR)
+	{
+		fprintf(stderr, "Error while writing the journal %s.\n", journal_path);
+		status = 1;
+	}
+	if (save_path && game_save(&loop.game, save_path) == ERROR)
+	{
+		fprintf(stderr, "Error while saving the snapshot %s.\n", save_path);
+		status = 1;
+	}
+	game_destroy(&loop.game); /*Frees the memory*/
+	return status;
+}
+
+/**
+* @brief Runs the game reading the keyboard
+*
+* game_loop_interactive starts the input and render threads and
+* applies the commands until the game finishes. The commands queued
+* together are applied in a row and published as a single snapshot,
+* and the timers start again after them
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loop is the loop, with the game already created
+* @return the exit status of the program
+*/
+int game_loop_interactive(Loop *loop)
+{
+	Command command;
+	pthread_t input, render;
+
+	/*Creates the graphic engine */
+	if ((loop->gengine = graphic_engine_create()) == NULL)
+	{
+		fprintf(stderr, "Error while initializing graphic engine.\n");
+		return 1;
+	}
+	graphic_feedback_init(&loop->feedback);
+	if ((loop->commands = spsc_queue_create()) == NULL)
+	{
+		fprintf(stderr, "Error while initializing the command queue.\n");
+		graphic_engine_destroy(loop->gengine);
+		return 1;
+	}
+	if ((loop->reader = command_reader_create(STDIN_FILENO)) == NULL)
+	{
+		fprintf(stderr, "Error while initializing the command reader.\n");
+		spsc_queue_destroy(loop->commands);
+		graphic_engine_destroy(loop->gengine);
+		return 1;
+	}
+	if ((loop->timers = timer_wheel_create(game_loop_now_ms(), loop)) == NULL)
+	{
+		fprintf(stderr, "Error while initializing the timers.\n");
+		command_reader_destroy(loop->reader);
+		spsc_queue_destroy(loop->commands);
+		graphic_engine_destroy(loop->gengine);
+		return 1;
+	}
+	if (loop->raw && game_loop_raw_begin(loop) == ERROR)
+	{
+		fprintf(stderr, "The input is not a terminal, reading lines.\n");
+		loop->raw = FALSE;
+	}
+	command_reader_set_raw(loop->reader, loop->raw);
+
+	sem_init(&loop->pending, 0, 0);
+	pthread_mutex_init(&loop->lock, NULL);
+	pthread_cond_init(&loop->published, NULL);
+	loop->seq = 0;
+	loop->done = FALSE;
+	loop->timed_turns = 0;
+	loop->kicked = FALSE;
+	timer_init(&loop->turn, game_loop_on_turn, NULL);
+	timer_init(&loop->idle, game_loop_on_idle, NULL);
+	timer_init(&loop->tick, game_loop_on_tick, NULL);
+	if (loop->autosave)
+		timer_wheel_schedule(loop->timers, &loop->tick, IDLE_TICK_S * 1000L);
+	game_loop_start_timers(loop);
+
+	command.cmd = NO_CMD;
+	game_loop_publish(loop, FALSE); /*The first frame*/
+	pthread_create(&render, NULL, game_loop_render, loop);
+	pthread_create(&input, NULL, game_loop_input, loop);
+
+	while ((command.cmd != EXIT) && !game_is_over(&loop->game))
+	{
+		if (game_loop_wait(loop) == ERROR)
+			break; /*Idle for too long, or finished by a timer*/
+		do
+		{
+			spsc_queue_pop(loop->commands, &command);   /*Takes the next command*/
+			game_update_command(&loop->game, &command); /*Upgrades the game*/
+		} while (command.cmd != EXIT && sem_trywait(&loop->pending) == 0);
+		if (command.cmd != EXIT)
+			game_loop_publish(loop, FALSE); /*Once for all the commands queued*/
+		if (loop->autosave)
+			autosave_tick(loop->autosave, &loop->game);
+		game_loop_start_timers(loop);
+	}
+	game_loop_publish(loop, TRUE);
+
+	pthread_join(render, NULL);
+	pthread_join(input, NULL); /*It sees the game finished at its next poll*/
+	if (loop->raw)
+		game_loop_raw_end(loop);
+	if (loop->timed_turns)
+		fprintf(stderr, "Turns played by the timer: %lu\n", loop->timed_turns);
+	if (loop->kicked)
+		fprintf(stderr, "No command for %ld ms, the game ends.\n", loop->idle_ms);
+
+	timer_wheel_cancel(loop->timers, &loop->turn);
+	timer_wheel_cancel(loop->timers, &loop->idle);
+	timer_wheel_cancel(loop->timers, &loop->tick);
+	timer_wheel_destroy(loop->timers);
+	pthread_cond_destroy(&loop->published);
+	pthread_mutex_destroy(&loop->lock);
+	sem_destroy(&loop->pending);
+	command_reader_destroy(loop->reader);
+	spsc_queue_destroy(loop->commands);
+	graphic_engine_destroy(loop->gengine); /*Frees the memory*/
+	return 0;
+}
+
+/**
+* @brief Runs the game reading the commands from a script
+*
+* game_loop_script applies every command of a file, or of the standard
+* input if it is "-", without painting anything, and prints a summary
+* of the final state and of the speed. With render_final the commands
+* applied are kept in the feedback, as when they are played, to paint
+* the final frame
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param script is the file with the commands or "-"
+* @param render_final is whether the final frame is painted
+* @param autosave is the autosave, or NULL
+* @return the exit status of the program
+*/
+int game_loop_script(Game *game, const char *script, BOOL render_final, Autosave *autosave)
+{
+	Command_reader *reader = NULL;
+	Graphic_engine *gengine = NULL;
+	Graphic_feedback feedback;
+	Game_state state;
+	Command command;
+	T_Command batch[SCRIPT_TICK];
+	struct timespec start, end;
+	unsigned long n = 0, ticked = 0, hits = 0, misses = 0;
+	size_t n_batch = 0, len = 0;
+	const char *frame = NULL;
+	double elapsed = 0;
+	int fd = STDIN_FILENO;
+
+	if (strcmp(script, "-") && (fd = open(script, O_RDONLY)) == -1)
+	{
+		fprintf(stderr, "Error while opening the script %s.\n", script);
+		return 1;
+	}
+	if ((reader = command_reader_create(fd)) == NULL)
+	{
+		fprintf(stderr, "Error while initializing the command reader.\n");
+		if (fd != STDIN_FILENO)
+			close(fd);
+		return 1;
+	}
+
+	graphic_feedback_init(&feedback);
+	game_get_state(game, &state);
+	if (render_final)
+		graphic_feedback_add(&feedback, &state); /*The first frame, as when played*/
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while (!game_is_over(game) && command_reader_next(reader, &command) == OK)
+	{
+		if (command.cmd == EXIT)
+			break;
+		n++;
+		if (render_final)
+		{
+			state.last_cmd = command.cmd; /*All the feedback keeps of a state*/
+			graphic_feedback_add(&feedback, &state);
+		}
+		if (!command.arg[0])
+		{
+			batch[n_batch++] = command.cmd; /*Applied with the next ones*/
+			if (n_batch < SCRIPT_TICK)
+				continue;
+		}
+
+		game_loop_script_apply(game, batch, n_batch);
+		n_batch = 0;
+		if (command.arg[0])
+			game_update_command(game, &command);
+		if (n - ticked >= SCRIPT_TICK && autosave)
+		{
+			autosave_tick(autosave, game);
+			ticked = n;
+		}
+	}
+	game_loop_script_apply(game, batch, n_batch);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	command_reader_destroy(reader);
+	if (fd != STDIN_FILENO)
+		close(fd);
+
+	if (render_final)
+	{
+		if ((gengine = graphic_engine_create()) == NULL)
+		{
+			fprintf(stderr, "Error while initializing graphic engine.\n");
+			return 1;
+		}
+		game_get_state(game, &state);
+		if ((frame = graphic_engine_render_frame(gengine, game, &state, &feedback, &len)))
+		{
+			fwrite(frame, 1, len, stdout);
+			fflush(stdout);
+		}
+		graphic_engine_get_cache_stats(gengine, &hits, &misses);
+		graphic_engine_destroy(gengine);
+		printf("\n");
+	}
+
+	elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("Commands: %lu\n", n);
+	printf("Player location: %ld\n", game_get_player_location(game));
+	printf("Object location: %ld%s\n", game_get_object_location(game),
+		   game_get_object_carried(game) ? " (carried)" : "");
+	printf("Last command: %s\n", cmd_to_str[game_get_last_command(game) - NO_CMD]);
+	printf("Elapsed: %.6f s\n", elapsed);
+	printf("Commands per second: %.0f\n", elapsed > 0 ? n / elapsed : 0.0);
+	if (render_final)
+		printf("Frame cache: %lu hits, %lu misses\n", hits, misses);
+
+	return 0;
+}
+
+/**
+* @brief Applies the commands of a script read in a row
+*
+* game_loop_script_apply gives the commands to game_update_many, and
+* applies alone the moves it stops at, so a blocked move is recorded
+* as when the commands are applied one by one. The rest of its run
+* stays blocked, so it is applied alone too
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param game is the game
+* @param cmds is the commands, none of them with an argument
+* @param n is the number of commands
+*/
+void game_loop_script_apply(Game *game, const T_Command *cmds, size_t n)
+{
+	size_t done = 0;
+	T_Command blocked = NO_CMD;
+
+	while ((done += game_update_many(game, cmds + done, n - done)) < n)
+	{
+		for (blocked = cmds[done]; done < n && cmds[done] == blocked; done++)
+			game_update(game, cmds[done]);
+	}
+}
+
+/**
+* @brief Reads the commands from the keyboard
+*
+* game_loop_input queues every command read until the exit command
+* or the end of the input. While there is no full command to read it
+* wakes up every INPUT_POLL_MS to check whether the game has finished
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param arg is the loop
+* @return NULL
+*/
+void *game_loop_input(void *arg)
+{
+	Loop *loop = (Loop *)arg;
+	Command command;
+	struct pollfd keyboard;
+	struct timespec wait = {0, 1000000L};
+
+	keyboard.fd = STDIN_FILENO;
+	keyboard.events = POLLIN;
+
+	while (!game_loop_is_done(loop))
+	{
+		if (!command_reader_pending(loop->reader))
+		{
+			if (poll(&keyboard, 1, INPUT_POLL_MS) <= 0)
+				continue; /*Nothing to read yet*/
+			command_reader_fill(loop->reader); /*A single read, a partial line does not block*/
+			if (!command_reader_pending(loop->reader))
+				continue;
+		}
+
+		if (command_reader_next(loop->reader, &command) == ERROR)
+		{
+			command.cmd = EXIT; /*End of the input*/
+			command.arg[0] = '\0';
+		}
+
+		while (spsc_queue_push(loop->commands, &command) == ERROR)
+			nanosleep(&wait, NULL); /*The queue is full*/
+		sem_post(&loop->pending);
+
+		if (command.cmd == EXIT)
+			break;
+	}
+
+	return NULL;
+}
+
+/**
+* @brief Paints the published snapshots
+*
+* game_loop_render paints the latest snapshot and then waits a frame
+* interval, so the snapshots published meanwhile are coalesced
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param arg is the loop
+* @return NULL
+*/
+void *game_loop_render(void *arg)
+{
+	Loop *loop = (Loop *)arg;
+	Game_state state;
+	unsigned long rendered = 0;
+	struct timespec interval = {0, FRAME_INTERVAL_NS};
+
+	pthread_mutex_lock(&loop->lock);
+	while (TRUE)
+	{
+		while (loop->seq == rendered && !loop->done)
+			pthread_cond_wait(&loop->published, &loop->lock);
+
+		if (loop->seq == rendered)
+			break; /*Done and nothing left to paint*/
+
+		state = loop->snapshot;
+		rendered = loop->seq;
+		pthread_mutex_unlock(&loop->lock);
+
+		game_loop_paint(loop->gengine, &loop->game, &state, &loop->feedback); /*Paints the game*/
+		nanosleep(&interval, NULL);
+
+		pthread_mutex_lock(&loop->lock);
+	}
+	pthread_mutex_unlock(&loop->lock);
+
+	return NULL;
+}
+
+/**
+* @brief Paints a frame of the game
+*
+* game_loop_paint adds the last command to the feedback and writes
+* the frame to the terminal at once
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param gengine is the graphic engine
+* @param game is the game
+* @param state is the state painted
+* @param feedback is the feedback of the game
+*/
+void game_loop_paint(Graphic_engine *gengine, Game *game, const Game_state *state, Graphic_feedback *feedback)
+{
+	const char *frame = NULL;
+	size_t len = 0;
+
+	if (!(frame = graphic_engine_render_state(gengine, game, state, feedback, &len)))
+		return;
+
+	fwrite(frame, 1, len, stdout);
+	fflush(stdout);
+}
+
+/**
+* @brief Publishes a snapshot of the game
+*
+* game_loop_publish copies the state of the game for the render thread,
+* or tells it that the game has finished
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loop is the loop
+* @param finish is TRUE to finish the loop instead of publishing
+*/
+void game_loop_publish(Loop *loop, BOOL finish)
+{
+	pthread_mutex_lock(&loop->lock);
+	if (finish)
+	{
+		loop->done = TRUE;
+	}
+	else
+	{
+		game_get_state(&loop->game, &loop->snapshot);
+		loop->seq++;
+	}
+	pthread_cond_signal(&loop->published);
+	pthread_mutex_unlock(&loop->lock);
+}
+
+/**
+* @brief Checks if the game has finished
+*
+* game_loop_is_done reads the done flag under the lock
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loop is the loop
+* @return TRUE if the game has finished
+*/
+BOOL game_loop_is_done(Loop *loop)
+{
+	BOOL done = FALSE;
+
+	pthread_mutex_lock(&loop->lock);
+	done = loop->done;
+	pthread_mutex_unlock(&loop->lock);
+
+	return done;
+}
+
+/**
+* @brief Puts the terminal in raw mode
+*
+* game_loop_raw_begin turns off the line editing, the echo and the
+* signal keys, so every key reaches the game as soon as it is pressed.
+* The output is left as it was
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loop is the loop, where the previous settings are saved
+* @return ERROR if the input is not a terminal
+*/
+STATUS game_loop_raw_begin(Loop *loop)
+{
+	struct termios raw;
+
+	if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &loop->saved) == -1)
+		return ERROR;
+
+	raw = loop->saved;
+	raw.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
+	raw.c_iflag &= ~(IXON | ICRNL);
+	raw.c_cc[VMIN] = 1;
+	raw.c_cc[VTIME] = 0;
+	if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == -1)
+		return ERROR;
+
+	return OK;
+}
+
+/**
+* @brief Restores the terminal
+*
+* game_loop_raw_end puts back the settings saved by game_loop_raw_begin
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loop is the loop
+*/
+void game_loop_raw_end(Loop *loop)
+{
+	tcsetattr(STDIN_FILENO, TCSANOW, &loop->saved);
+}
+
+/**
+* @brief Applies a command of the journal
+*
+* game_loop_replay is called for every command recorded in the journal
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param data is the game
+* @param command is the command
+* @return the status
+*/
+STATUS game_loop_replay(void *data, const Command *command)
+{
+	return game_update_command((Game *)data, command);
+}
+
+/**
+* @brief Waits for a command
+*
+* game_loop_wait waits until there is a command in the queue, running
+* the timers that expire meanwhile
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loop is the loop
+* @return ERROR if the game has to end before any command comes
+*/
+STATUS game_loop_wait(Loop *loop)
+{
+	struct timespec deadline;
+	long next = 0;
+
+	while (TRUE)
+	{
+		timer_wheel_advance(loop->timers, game_loop_now_ms());
+		if (loop->kicked || game_is_over(&loop->game))
+			return ERROR;
+
+		if ((next = timer_wheel_next(loop->timers)) < 0)
+		{
+			if (sem_wait(&loop->pending) == 0)
+				return OK;
+			continue; /*Interrupted*/
+		}
+
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += next / 1000;
+		deadline.tv_nsec += (next % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+		if (sem_timedwait(&loop->pending, &deadline) == 0)
+			return OK;
+	}
+}
+
+/**
+* @brief Starts the timers of a turn
+*
+* game_loop_start_timers schedules the turn and idle timers again, as
+* a command has just come
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loop is the loop
+*/
+void game_loop_start_timers(Loop *loop)
+{
+	timer_wheel_advance(loop->timers, game_loop_now_ms());
+	if (loop->turn_ms > 0)
+		timer_wheel_schedule(loop->timers, &loop->turn, (unsigned long)loop->turn_ms);
+	if (loop->idle_ms > 0)
+		timer_wheel_schedule(loop->timers, &loop->idle, (unsigned long)loop->idle_ms);
+}
+
+/**
+* @brief Plays the turn of a player who takes too long
+*
+* game_loop_on_turn moves the player to the next space and gives
+* the player another turn
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the loop
+* @param data is not used
+*/
+void game_loop_on_turn(void *context, void *data)
+{
+	Loop *loop = (Loop *)context;
+	Command command;
+
+	command.cmd = NEXT;
+	command.arg[0] = '\0';
+	game_update_command(&loop->game, &command);
+	game_loop_publish(loop, FALSE);
+	loop->timed_turns++;
+
+	if (!game_is_over(&loop->game))
+		timer_wheel_schedule(loop->timers, &loop->turn, (unsigned long)loop->turn_ms);
+}
+
+/**
+* @brief Ends the game of a player who is away
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the loop
+* @param data is not used
+*/
+void game_loop_on_idle(void *context, void *data)
+{
+	((Loop *)context)->kicked = TRUE;
+}
+
+/**
+* @brief Checks the autosave while there is no input
+*
+* game_loop_on_tick runs every IDLE_TICK_S, so the last changes are
+* saved even if no more commands come
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the loop
+* @param data is not used
+*/
+void game_loop_on_tick(void *context, void *data)
+{
+	Loop *loop = (Loop *)context;
+
+	autosave_tick(loop->autosave, &loop->game);
+	timer_wheel_schedule(loop->timers, &loop->tick, IDLE_TICK_S * 1000L);
+}
+
+/**
+* @brief Gets the time of a monotonic clock
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @return the time, in milliseconds
+*/
+unsigned long game_loop_now_ms()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+* @brief Prints the metrics of the autosave
+*
+* game_loop_print_autosave prints the metrics to the error output,
+* so they do not mix with the game
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param autosave is the autosave
+*/
+void game_loop_print_autosave(Autosave *autosave)
+{
+	Autosave_stats stats;
+
+	autosave_get_stats(autosave, &stats);
+	fprintf(stderr, "Autosaves: %lu, failed: %lu\n", stats.saves, stats.failures);
+	fprintf(stderr, "Last snapshot: %ld bytes in %.3f ms, longest %.3f ms\n",
+			stats.last_size, stats.last_ms, stats.max_ms);
+	fprintf(stderr, "Game stopped by fork: last %.1f us, longest %.1f us\n",
+			stats.fork_us, stats.max_fork_us);
+}
@@ -1,89 +1,93 @@
-/** 
- * @brief It takes the information from a file to create 
- * the game and defines the interface.
- * 
- * @file game_reader.c
- * @author David Ramirez
- * @version 1.0 
- * @date 10/02/2019
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "game_reader.h"
-#include "game.h"
-
-/**
-* @brief Computes the creation of the game
-*
-* game_reader_load_spaces 
-*
-* @date 11/02/2019
-* @author David Ramirez
-* @param game is the game which has been created
-* @param filename is the file which is going to be read
-* @return the status (if the game has been created successfully or not)
-*/
-STATUS game_reader_load_spaces(Game *game, char *filename)
-{
-  FILE *file = NULL;
-  char line[WORD_SIZE] = "";
-  char name[WORD_SIZE] = "";
-  char *toks = NULL;
-  Id id = NO_ID, north = NO_ID, east = NO_ID, south = NO_ID, west = NO_ID;
-  Space *space = NULL;
-  STATUS status = OK;
-
-  if (!filename)
-  {
-    return ERROR;
-  }
-
-  file = fopen(filename, "r");
-  if (file == NULL)
-  {
-    return ERROR;
-  }
-
-  while (fgets(line, WORD_SIZE, file))
-  {
-    if (strncmp("#s:", line, 3) == 0)
-    {
-      toks = strtok(line + 3, "|");
-      id = atol(toks);
-      toks = strtok(NULL, "|");
-      strcpy(name, toks);
-      toks = strtok(NULL, "|");
-      north = atol(toks);
-      toks = strtok(NULL, "|");
-      east = atol(toks);
-      toks = strtok(NULL, "|");
-      south = atol(toks);
-      toks = strtok(NULL, "|");
-      west = atol(toks);
-#ifdef DEBUG
-      printf("Leido: %ld|%s|%ld|%ld|%ld|%ld\n", id, name, north, east, south, west);
-#endif
-      space = space_create(id);
-      if (space != NULL)
-      {
-        space_set_name(space, name);
-        space_set_north(space, north);
-        space_set_east(space, east);
-        space_set_south(space, south);
-        space_set_west(space, west);
-        game_add_space(game, space);
-      }
-    }
-  }
-
-  if (ferror(file))
-  {
-    status = ERROR;
-  }
-
-  fclose(file);
-
-  return status;
-}
+/** 
+ * @brief It takes the information from a file to create 
+ * the game and defines the interface.
+ * 
+ * @file game_reader.c
+ * @author David Ramirez
+ * @version 1.0 
+ * @date 10/02/2019
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game_reader.h"
+#include "game.h"
+
+/**
+* @brief Computes the creation of the game
+*
+* game_reader_load_spaces 
+*
+* @date 11/02/2019
+* @author David Ramirez
+* @param game is the game which has been created
+* @param filename is the file which is going to be read
+* @return the status (if the game has been created successfully or not)
+*/
+STATUS game_reader_load_spaces(World *world, char *filename)
+{
+  FILE *file = NULL;
+  char line[WORD_SIZE] = "";
+  char name[WORD_SIZE] = "";
+  char *toks = NULL, *save = NULL;
+  Id id = NO_ID, north = NO_ID, east = NO_ID, south = NO_ID, west = NO_ID;
+  Space *space = NULL;
+  STATUS status = OK;
+
+  if (!filename)
+  {
+    return ERROR;
+  }
+
+  file = fopen(filename, "r");
+  if (file == NULL)
+  {
+    return ERROR;
+  }
+
+  while (fgets(line, WORD_SIZE, file))
+  {
+    if (strncmp("#s:", line, 3) == 0)
+    {
+      /* strtok_r, so several games can be loaded at the same time */
+      toks = strtok_r(line + 3, "|", &save);
+      id = atol(toks);
+      toks = strtok_r(NULL, "|", &save);
+      strcpy(name, toks);
+      toks = strtok_r(NULL, "|", &save);
+      north = atol(toks);
+      toks = strtok_r(NULL, "|", &save);
+      east = atol(toks);
+      toks = strtok_r(NULL, "|", &save);
+      south = atol(toks);
+      toks = strtok_r(NULL, "|", &save);
+      west = atol(toks);
+#ifdef DEBUG
+      printf("Leido: %ld|%s|%ld|%ld|%ld|%ld\n", id, name, north, east, south, west);
+#endif
+      space = space_create(id);
+      if (space != NULL)
+      {
+        space_set_name(space, name);
+        space_set_north(space, north);
+        space_set_east(space, east);
+        space_set_south(space, south);
+        space_set_west(space, west);
+        if (world_add_space(world, space) == ERROR)
+          space_destroy(space);
+      }
+    }
+  }
+
+  if (ferror(file))
+  {
+    status = ERROR;
+  }
+
+  fclose(file);
+
+  return status;
+}
@@ -1,149 +1,345 @@
-/** 
- * @brief It takes the information from a file to create 
- * the game and defines the interface.
- * 
- * @file game_reader.c
- * @author David Ramirez
- * @version 1.1 
- * @date 12/02/2019
- */
-#include <stdlib.h>
-#include <stdio.h>
-#include "screen.h"
-#include "graphic_engine.h"
-
-struct _Graphic_engine
-{
-  Area *map, *descript, *banner, *help, *feedback;
-};
-
-Graphic_engine *graphic_engine_create()
-{
-  static Graphic_engine *ge = NULL;
-
-  if (ge)
-    return ge;
-
-  screen_init();
-  ge = (Graphic_engine *)malloc(sizeof(Graphic_engine));
-
-  ge->map = screen_area_init(1, 1, 48, 13);
-  ge->descript = screen_area_init(50, 1, 29, 13);
-  ge->banner = screen_area_init(28, 15, 23, 1);
-  ge->help = screen_area_init(1, 16, 78, 2);
-  ge->feedback = screen_area_init(1, 19, 78, 3);
-
-  return ge;
-}
-
-void graphic_engine_destroy(Graphic_engine *ge)
-{
-  if (!ge)
-    return;
-
-  screen_area_destroy(ge->map);
-  screen_area_destroy(ge->descript);
-  screen_area_destroy(ge->banner);
-  screen_area_destroy(ge->help);
-  screen_area_destroy(ge->feedback);
-
-  screen_destroy();
-  free(ge);
-}
-
-void graphic_engine_paint_game(Graphic_engine *ge, Game *game)
-{
-  Id id_act = NO_ID, id_back = NO_ID, id_next = NO_ID, obj_loc = NO_ID;
-  Space *space_act = NULL;
-  char obj = '\0';
-  char str[255];
-  T_Command last_cmd = UNKNOWN;
-  extern char *cmd_to_str[];
-
-  /* Paint the in the map area */
-  screen_area_clear(ge->map);
-  if ((id_act = game_get_player_location(game)) != NO_ID)
-  {
-    space_act = game_get_space(game, id_act);
-    id_back = space_get_north(space_act);
-    id_next = space_get_south(space_act);
-
-    if (game_get_object_location(game) == id_back)
-      obj = '*';
-    else
-      obj = ' ';
-
-    if (id_back != NO_ID)
-    {
-      sprintf(str, "  |         %2d|", (int)id_back);
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  |     %c     |", obj);
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  +-----------+");
-      screen_area_puts(ge->map, str);
-      sprintf(str, "        ^");
-      screen_area_puts(ge->map, str);
-    }
-
-    if (game_get_object_location(game) == id_act)
-      obj = '*';
-    else
-      obj = ' ';
-
-    if (id_act != NO_ID)
-    {
-      sprintf(str, "  +-----------+");
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  | 8D      %2d|", (int)id_act);
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  |     %c     |", obj);
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  +-----------+");
-      screen_area_puts(ge->map, str);
-    }
-
-    if (game_get_object_location(game) == id_next)
-      obj = '*';
-    else
-      obj = ' ';
-
-    if (id_next != NO_ID)
-    {
-      sprintf(str, "        v");
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  +-----------+");
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  |         %2d|", (int)id_next);
-      screen_area_puts(ge->map, str);
-      sprintf(str, "  |     %c     |", obj);
-      screen_area_puts(ge->map, str);
-    }
-  }
-
-  /* Paint the in the description area */
-  screen_area_clear(ge->descript);
-  if ((obj_loc = game_get_object_location(game)) != NO_ID)
-  {
-    sprintf(str, "  Object location:%d", (int)obj_loc);
-    screen_area_puts(ge->descript, str);
-  }
-
-  /* Paint the in the banner area */
-  screen_area_puts(ge->banner, " The game of the Goose ");
-
-  /* Paint the in the help area */
-  screen_area_clear(ge->help);
-  sprintf(str, " The commands you can use are:");
-  screen_area_puts(ge->help, str);
-  sprintf(str, "     next or n, back or b, exit or e, take or t, drop or d");
-  screen_area_puts(ge->help, str);
-
-  /* Paint the in the feedback area */
-  last_cmd = game_get_last_command(game);
-  sprintf(str, " %s", cmd_to_str[last_cmd - NO_CMD]);
-  screen_area_puts(ge->feedback, str);
-
-  /* Dump to the terminal */
-  screen_paint();
-  printf("prompt:> ");
-}
+/** 
+ * @brief It takes the information from a file to create 
+ * the game and defines the interface.
+ * 
+ * @file game_reader.c
+ * @author David Ramirez
+ * @version 1.1 
+ * @date 12/02/2019
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "screen.h"
+#include "frame_cache.h"
+#include "graphic_engine.h"
+
+#define PROMPT "prompt:> "
+
+#define FEEDBACK_HEIGHT 3
+
+#define MAP_WIDTH 48
+#define MAP_HEIGHT 13
+#define MAP_CELL_WIDTH 9  /* "[@ 12 *]" plus the link to the east */
+#define MAP_CELL_HEIGHT 2 /* The box plus the link to the south */
+#define MAP_COLUMNS (MAP_WIDTH / MAP_CELL_WIDTH)
+#define MAP_ROWS (MAP_HEIGHT / MAP_CELL_HEIGHT)
+
+/*
+ * An engine has its own screen, so there can be one per thread, and
+ * the feedback of the game it paints is passed with every frame, so
+ * one engine can paint many games
+ */
+struct _Graphic_engine
+{
+  Screen *screen;
+  Area *map, *descript, *banner, *help, *feedback;
+  Frame_cache *cache;         /* Frames already composed */
+  char frame[SCREEN_RENDER_MAX + sizeof(PROMPT)];
+};
+
+void graphic_engine_compose(Graphic_engine *ge, Game *game, const Game_state *state, const Graphic_feedback *feedback);
+void graphic_engine_paint_map(Graphic_engine *ge, Game *game, const Game_state *state);
+void graphic_engine_paint_feedback(Graphic_engine *ge, const Graphic_feedback *feedback, int scroll);
+int graphic_feedback_get(const Graphic_feedback *feedback, int line);
+
+Graphic_engine *graphic_engine_create()
+{
+  Graphic_engine *ge = NULL;
+
+  ge = (Graphic_engine *)calloc(1, sizeof(Graphic_engine));
+  if (!ge)
+    return NULL;
+
+  if (!(ge->screen = screen_init()) || !(ge->cache = frame_cache_create()))
+  {
+    graphic_engine_destroy(ge);
+    return NULL;
+  }
+
+  ge->map = screen_area_init(ge->screen, 1, 1, MAP_WIDTH, MAP_HEIGHT);
+  ge->descript = screen_area_init(ge->screen, 50, 1, 29, 13);
+  ge->banner = screen_area_init(ge->screen, 28, 15, 23, 1);
+  ge->help = screen_area_init(ge->screen, 1, 16, 78, 2);
+  ge->feedback = screen_area_init(ge->screen, 1, 19, 78, FEEDBACK_HEIGHT);
+  if (!ge->map || !ge->descript || !ge->banner || !ge->help || !ge->feedback)
+  {
+    graphic_engine_destroy(ge);
+    return NULL;
+  }
+
+  return ge;
+}
+
+void graphic_engine_destroy(Graphic_engine *ge)
+{
+  if (!ge)
+    return;
+
+  screen_area_destroy(ge->map);
+  screen_area_destroy(ge->descript);
+  screen_area_destroy(ge->banner);
+  screen_area_destroy(ge->help);
+  screen_area_destroy(ge->feedback);
+  frame_cache_destroy(ge->cache);
+
+  screen_destroy(ge->screen);
+  free(ge);
+}
+
+const char *graphic_engine_render_state(Graphic_engine *ge, Game *game, const Game_state *state,
+                                        Graphic_feedback *feedback, size_t *len)
+{
+  if (!ge || !game || !state || !feedback || !len)
+    return NULL;
+
+  graphic_feedback_add(feedback, state);
+  return graphic_engine_render_frame(ge, game, state, feedback, len);
+}
+
+/* Paints the frame again without touching the feedback, as for a
+   spectator joining a game */
+const char *graphic_engine_render_frame(Graphic_engine *ge, Game *game, const Game_state *state,
+                                        const Graphic_feedback *feedback, size_t *len)
+{
+  Frame_key key;
+  const char *frame = NULL;
+  int i = 0;
+
+  if (!ge || !game || !state || !feedback || !len)
+    return NULL;
+
+  /* The frame only depends on these inputs, so a state seen before
+     is dumped straight from the cache without composing anything.
+     Older feedback lines are not part of the key, so a scrolled
+     back frame is always composed */
+  key.player_location = state->player_location;
+  key.object_location = state->object_location;
+  key.carried = state->carried;
+  key.map_view = state->map_view;
+  for (i = 0; i < FRAME_KEY_HISTORY; i++)
+    key.history[i] = graphic_feedback_get(feedback, feedback->count - FRAME_KEY_HISTORY + i);
+
+  if (state->scroll > 0 || !(frame = frame_cache_get(ge->cache, &key, len)))
+  {
+    graphic_engine_compose(ge, game, state, feedback);
+    *len = screen_render(ge->screen, ge->frame, SCREEN_RENDER_MAX);
+    memcpy(ge->frame + *len, PROMPT, sizeof(PROMPT) - 1);
+    *len += sizeof(PROMPT) - 1;
+    if (state->scroll == 0)
+      frame_cache_put(ge->cache, &key, ge->frame, *len);
+    frame = ge->frame;
+  }
+
+  return frame;
+}
+
+/* Scrolling only moves the feedback window, the rest of
+   commands are appended to the feedback ring */
+void graphic_feedback_add(Graphic_feedback *feedback, const Game_state *state)
+{
+  if (!feedback || !state || state->last_cmd == UP || state->last_cmd == DOWN)
+    return;
+
+  feedback->lines[feedback->head] = (unsigned char)(state->last_cmd - NO_CMD);
+  feedback->head = (feedback->head + 1) % GRAPHIC_FEEDBACK_LINES;
+  if (feedback->count < GRAPHIC_FEEDBACK_LINES)
+    feedback->count++;
+}
+
+void graphic_feedback_init(Graphic_feedback *feedback)
+{
+  if (!feedback)
+    return;
+
+  feedback->head = 0;
+  feedback->count = 0;
+}
+
+void graphic_engine_get_cache_stats(Graphic_engine *ge, unsigned long *hits, unsigned long *misses)
+{
+  if (!ge)
+    return;
+
+  if (hits)
+    *hits = frame_cache_hits(ge->cache);
+  if (misses)
+    *misses = frame_cache_misses(ge->cache);
+}
+
+void graphic_engine_compose(Graphic_engine *ge, Game *game, const Game_state *state, const Graphic_feedback *feedback)
+{
+  Id id_act = NO_ID, id_back = NO_ID, id_next = NO_ID, obj_loc = NO_ID;
+  Space *space_act = NULL;
+  char obj = '\0';
+  char str[255];
+
+  /* Paint the in the map area */
+  screen_area_clear(ge->map);
+  if (state->map_view)
+  {
+    graphic_engine_paint_map(ge, game, state);
+  }
+  else if ((id_act = state->player_location) != NO_ID)
+  {
+    space_act = game_get_space(game, id_act);
+    id_back = space_get_north(space_act);
+    id_next = space_get_south(space_act);
+
+    if (state->object_location == id_back)
+      obj = '*';
+    else
+      obj = ' ';
+
+    if (id_back != NO_ID)
+    {
+      sprintf(str, "  |         %2d|", (int)id_back);
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  |     %c     |", obj);
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  +-----------+");
+      screen_area_puts(ge->map, str);
+      sprintf(str, "        ^");
+      screen_area_puts(ge->map, str);
+    }
+
+    if (state->object_location == id_act)
+      obj = '*';
+    else
+      obj = ' ';
+
+    if (id_act != NO_ID)
+    {
+      sprintf(str, "  +-----------+");
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  | 8D      %2d|", (int)id_act);
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  |     %c     |", obj);
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  +-----------+");
+      screen_area_puts(ge->map, str);
+    }
+
+    if (state->object_location == id_next)
+      obj = '*';
+    else
+      obj = ' ';
+
+    if (id_next != NO_ID)
+    {
+      sprintf(str, "        v");
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  +-----------+");
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  |         %2d|", (int)id_next);
+      screen_area_puts(ge->map, str);
+      sprintf(str, "  |     %c     |", obj);
+      screen_area_puts(ge->map, str);
+    }
+  }
+
+  /* Paint the in the description area */
+  screen_area_clear(ge->descript);
+  if ((obj_loc = state->object_location) != NO_ID)
+  {
+    sprintf(str, "  Object location:%d", (int)obj_loc);
+    screen_area_puts(ge->descript, str);
+  }
+
+  /* Paint the in the banner area */
+  screen_area_puts(ge->banner, " The game of the Goose ");
+
+  /* Paint the in the help area */
+  screen_area_clear(ge->help);
+  sprintf(str, " Commands: next or n [count], back or b [count], goto or g <space>, take or t,");
+  screen_area_puts(ge->help, str);
+  sprintf(str, "     drop or d, undo or z, redo or y, map or m, up or k, down or j, exit or e");
+  screen_area_puts(ge->help, str);
+
+  /* Paint the in the feedback area from the ring */
+  graphic_engine_paint_feedback(ge, feedback, state->scroll);
+}
+
+void graphic_engine_paint_feedback(Graphic_engine *ge, const Graphic_feedback *feedback, int scroll)
+{
+  char str[SCREEN_MAX_STR];
+  int first = 0, line = 0;
+  extern const char *const cmd_to_str[];
+
+  /* Show the window that ends scroll lines before the newest one,
+     clamped to the lines kept in the ring */
+  if (scroll > feedback->count - FEEDBACK_HEIGHT)
+    scroll = feedback->count - FEEDBACK_HEIGHT;
+  if (scroll < 0)
+    scroll = 0;
+  first = feedback->count - FEEDBACK_HEIGHT - scroll;
+  if (first < 0)
+    first = 0;
+
+  screen_area_clear(ge->feedback);
+  for (line = first; line < feedback->count && line < first + FEEDBACK_HEIGHT; line++)
+  {
+    str[0] = ' ';
+    strncpy(str + 1, cmd_to_str[graphic_feedback_get(feedback, line) - NO_CMD], SCREEN_MAX_STR - 2);
+    str[SCREEN_MAX_STR - 1] = '\0';
+    screen_area_puts(ge->feedback, str);
+  }
+}
+
+int graphic_feedback_get(const Graphic_feedback *feedback, int line)
+{
+  if (line < 0 || line >= feedback->count)
+    return FRAME_EMPTY_LINE;
+
+  /* Line 0 is the oldest one kept */
+  return (int)feedback->lines[(feedback->head - feedback->count + line + GRAPHIC_FEEDBACK_LINES) %
+                              GRAPHIC_FEEDBACK_LINES] + NO_CMD;
+}
+
+void graphic_engine_paint_map(Graphic_engine *ge, Game *game, const Game_state *state)
+{
+  Space *visible[MAP_COLUMNS * MAP_ROWS];
+  Space *space = NULL, *neighbour = NULL;
+  char rows[MAP_ROWS * MAP_CELL_HEIGHT][MAP_WIDTH + 1];
+  char box[MAP_CELL_WIDTH + 1];
+  int x0 = 0, y0 = 0, x = 0, y = 0, n = 0, i = 0;
+
+  if (!(space = game_get_space(game, state->player_location)))
+    return;
+
+  /* The viewport follows the player, and only the spaces inside it are visited */
+  x0 = space_get_x(space) - MAP_COLUMNS / 2;
+  y0 = space_get_y(space) - MAP_ROWS / 2;
+  n = map_grid_query(game_get_map_grid(game), x0, y0, x0 + MAP_COLUMNS - 1, y0 + MAP_ROWS - 1,
+                     visible, MAP_COLUMNS * MAP_ROWS);
+
+  for (i = 0; i < MAP_ROWS * MAP_CELL_HEIGHT; i++)
+  {
+    memset(rows[i], ' ', MAP_WIDTH);
+    rows[i][MAP_WIDTH] = '\0';
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    space = visible[i];
+    x = (space_get_x(space) - x0) * MAP_CELL_WIDTH;
+    y = (space_get_y(space) - y0) * MAP_CELL_HEIGHT;
+
+    sprintf(box, "[%c%4ld%c]",
+            (space_get_id(space) == state->player_location) ? '@' : ' ',
+            (long)space_get_id(space) % 10000,
+            (space_get_id(space) == state->object_location) ? '*' : ' ');
+    memcpy(rows[y] + x, box, MAP_CELL_WIDTH - 1);
+
+    /* Links are only drawn between spaces laid out side by side */
+    neighbour = map_grid_get(game_get_map_grid(game), space_get_x(space) + 1, space_get_y(space));
+    if (neighbour && space_get_id(neighbour) == space_get_east(space))
+      rows[y][x + MAP_CELL_WIDTH - 1] = '-';
+    neighbour = map_grid_get(game_get_map_grid(game), space_get_x(space), space_get_y(space) + 1);
+    if (neighbour && space_get_id(neighbour) == space_get_south(space))
+      rows[y + 1][x + MAP_CELL_WIDTH / 2 - 1] = '|';
+  }
+
+  for (i = 0; i < MAP_ROWS * MAP_CELL_HEIGHT; i++)
+    screen_area_puts(ge->map, rows[i]);
+}
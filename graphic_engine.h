@@ -1,23 +1,45 @@
-/** 
- * @brief It defines a textual graphic engine
- * 
- * @file graphic_engine.h
- * @author Profesores PPROG
- * @version 1.0 
- * @date 18/01/2017
- * @copyright GNU Public License
- */
-
-#ifndef __GRAPHIC_ENGINE__
-#define __GRAPHIC_ENGINE__
-
-#include "game.h"
-
-typedef struct _Graphic_engine Graphic_engine;
-
-Graphic_engine *graphic_engine_create();
-void graphic_engine_destroy(Graphic_engine *ge);
-void graphic_engine_paint_game(Graphic_engine *ge, Game *game);
-void graphic_engine_write_command(Graphic_engine *ge, char *str);
-
-#endif
+/** 
+ * @brief It defines a textual graphic engine
+ * 
+ * @file graphic_engine.h
+ * @author Profesores PPROG
+ * @version 1.0 
+ * @date 18/01/2017
+ * @copyright GNU Public License
+ */
+
+#ifndef __GRAPHIC_ENGINE__
+#define __GRAPHIC_ENGINE__
+
+#include <stddef.h>
+#include "game.h"
+
+#define GRAPHIC_FEEDBACK_LINES (GAME_MAX_SCROLL + 3) /* Kept for scrollback */
+
+typedef struct _Graphic_engine Graphic_engine;
+
+/**
+ * @brief The commands shown in the feedback area
+ *
+ * It is all that is kept of a game between two frames, so one
+ * engine can paint many games, each with its own feedback
+ */
+typedef struct _Graphic_feedback
+{
+  unsigned char lines[GRAPHIC_FEEDBACK_LINES]; /*!< Ring of the commands shown, minus NO_CMD */
+  short head;                                  /*!< Slot of the next line */
+  short count;                                 /*!< Number of lines in the ring */
+} Graphic_feedback;
+
+Graphic_engine *graphic_engine_create();
+void graphic_engine_destroy(Graphic_engine *ge);
+const char *graphic_engine_render_state(Graphic_engine *ge, Game *game, const Game_state *state,
+                                        Graphic_feedback *feedback, size_t *len);
+const char *graphic_engine_render_frame(Graphic_engine *ge, Game *game, const Game_state *state,
+                                        const Graphic_feedback *feedback, size_t *len);
+void graphic_feedback_init(Graphic_feedback *feedback);
+void graphic_feedback_add(Graphic_feedback *feedback, const Game_state *state);
+void graphic_engine_write_command(Graphic_engine *ge, char *str);
+void graphic_engine_get_cache_stats(Graphic_engine *ge, unsigned long *hits, unsigned long *misses);
+
+#endif
@@ -0,0 +1,738 @@
+/**
+ * @brief It implements the journal of the commands of a session
+ *
+ * The journal is an append-only file: a header and then one record per
+ * command applied. A record is the command byte, with the high bits
+ * telling what argument follows: a number as a varint, or a text as a
+ * varint length and its bytes. Every JOURNAL_CHECKPOINT commands there
+ * is also a checkpoint record with the hash of the state of the game,
+ * so a replay can tell where it stopped matching the recording.
+ *
+ * The game only copies the record to a buffer in memory. A writer
+ * thread takes everything buffered at once, writes it with a single
+ * call and fsyncs at most once per interval, so many commands share
+ * each trip to the disk and the game never waits for it. A record cut
+ * by a crash is dropped when the journal is replayed.
+ *
+ * @file journal.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "journal.h"
+
+#define JOURNAL_MAGIC "OCAJ\001" /* Name and version of the format */
+#define JOURNAL_MAGIC_LEN 5
+#define JOURNAL_NUMBER 0x80      /* A varint number follows the command byte */
+#define JOURNAL_TEXT 0x40        /* A varint length and a text follow */
+#define JOURNAL_CMD_MASK 0x3f
+#define JOURNAL_CHECK 0x3f       /* A checkpoint: 8 bytes of hash follow */
+#define JOURNAL_CHECK_LEN 9
+#define JOURNAL_BUFFER_SIZE 4096
+#define JOURNAL_MAX_DIGITS 18    /* Numbers that always fit in a long */
+
+/**
+ * @brief The structure of the journal
+ *
+ * It stores the file, the records not written yet and the state
+ * of the writer thread
+ */
+struct _Journal
+{
+  int fd;                 /*!< Descriptor of the file */
+  long fsync_ms;          /*!< Time between two fsync, 0 for every write, negative for never */
+  pthread_t writer;       /*!< Thread that writes the records */
+  pthread_mutex_t lock;   /*!< Protects the buffer and the flags below */
+  pthread_cond_t wake;    /*!< Signaled when there are records or it is closing */
+  unsigned char *buf;     /*!< Records not written yet */
+  size_t len, size;       /*!< Bytes used and allocated of the buffer */
+  unsigned char *spare;   /*!< Records being written, only touched by the writer */
+  size_t spare_size;      /*!< Bytes allocated of the spare buffer */
+  unsigned long appended; /*!< Commands appended since it was opened */
+  BOOL closing;           /*!< Whether the journal is being closed */
+  BOOL failed;            /*!< Whether a write failed */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+void *journal_writer(void *arg);
+STATUS journal_write_all(int fd, const unsigned char *buf, size_t len);
+unsigned char *journal_read_all(int fd, size_t *len);
+STATUS journal_repair(int fd);
+STATUS journal_push(Journal *journal, const unsigned char *record, size_t len);
+size_t journal_encode_check(unsigned long hash, unsigned char *buf);
+size_t journal_put_varint(unsigned long value, unsigned char *buf);
+size_t journal_get_varint(const unsigned char *buf, size_t len, unsigned long *value);
+long journal_ms_since(const struct timespec *since);
+
+/**
+* @brief Computes the opening of the journal
+*
+* journal_open opens a journal to append records to it, writing
+* the header if the file is new, and starts its writer thread. A record
+* cut at the end of the file by a crash is removed first, so the new
+* records follow the last whole one
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param path is the file of the journal
+* @param fsync_ms is the time between two fsync, 0 to fsync every
+* write and negative to leave it to the system
+* @return the journal or NULL if it could not be opened
+*/
+Journal *journal_open(const char *path, long fsync_ms)
+{
+  Journal *journal = NULL;
+
+  if (!path || !(journal = (Journal *)calloc(1, sizeof(Journal))))
+    return NULL;
+
+  journal->fsync_ms = fsync_ms;
+  journal->size = journal->spare_size = JOURNAL_BUFFER_SIZE;
+  journal->buf = (unsigned char *)malloc(journal->size);
+  journal->spare = (unsigned char *)malloc(journal->spare_size);
+  if (!journal->buf || !journal->spare ||
+      (journal->fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644)) == -1)
+  {
+    free(journal->buf);
+    free(journal->spare);
+    free(journal);
+    return NULL;
+  }
+
+  if (journal_repair(journal->fd) == ERROR)
+  {
+    close(journal->fd);
+    free(journal->buf);
+    free(journal->spare);
+    free(journal);
+    return NULL;
+  }
+
+  pthread_mutex_init(&journal->lock, NULL);
+  pthread_cond_init(&journal->wake, NULL);
+  if (pthread_create(&journal->writer, NULL, journal_writer, journal))
+  {
+    pthread_cond_destroy(&journal->wake);
+    pthread_mutex_destroy(&journal->lock);
+    close(journal->fd);
+    free(journal->buf);
+    free(journal->spare);
+    free(journal);
+    return NULL;
+  }
+
+  return journal;
+}
+
+/**
+* @brief Computes the closing of the journal
+*
+* journal_close waits for the writer thread to write and fsync every
+* record appended, and frees the journal
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param journal is the journal
+* @return ERROR if some record could not be written
+*/
+STATUS journal_close(Journal *journal)
+{
+  BOOL failed = FALSE;
+
+  if (!journal)
+    return ERROR;
+
+  pthread_mutex_lock(&journal->lock);
+  journal->closing = TRUE;
+  pthread_cond_signal(&journal->wake);
+  pthread_mutex_unlock(&journal->lock);
+  pthread_join(journal->writer, NULL);
+
+  failed = journal->failed;
+  pthread_cond_destroy(&journal->wake);
+  pthread_mutex_destroy(&journal->lock);
+  close(journal->fd);
+  free(journal->buf);
+  free(journal->spare);
+  free(journal);
+
+  return failed ? ERROR : OK;
+}
+
+/**
+* @brief Adds a command to the journal
+*
+* journal_append encodes the command into the buffer of the writer
+* thread, it never waits for the disk
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param journal is the journal
+* @param command is the command applied
+* @param hash is the hash of the state after the command, it is
+* recorded every JOURNAL_CHECKPOINT commands
+* @return ERROR if there is no memory
+*/
+STATUS journal_append(Journal *journal, const Command *command, unsigned long hash)
+{
+  unsigned char record[JOURNAL_RECORD_MAX + JOURNAL_CHECK_LEN];
+  size_t len = 0;
+
+  if (!journal || !command)
+    return ERROR;
+
+  len = journal_encode(command, record);
+  if (++journal->appended % JOURNAL_CHECKPOINT == 0)
+    len += journal_encode_check(hash, record + len);
+
+  return journal_push(journal, record, len);
+}
+
+/**
+* @brief Adds a checkpoint to the journal
+*
+* journal_checkpoint records the hash of the state right now, as
+* when a session ends
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param journal is the journal
+* @param hash is the hash of the state
+* @return ERROR if there is no memory
+*/
+STATUS journal_checkpoint(Journal *journal, unsigned long hash)
+{
+  unsigned char record[JOURNAL_CHECK_LEN];
+
+  if (!journal)
+    return ERROR;
+
+  return journal_push(journal, record, journal_encode_check(hash, record));
+}
+
+/**
+* @brief Copies a record to the buffer
+*
+* journal_push copies an encoded record to the buffer of the writer
+* thread, waking it up if it was idle
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param journal is the journal
+* @param record is the record
+* @param len is the length of the record
+* @return ERROR if there is no memory
+*/
+STATUS journal_push(Journal *journal, const unsigned char *record, size_t len)
+{
+  unsigned char *aux = NULL;
+
+  pthread_mutex_lock(&journal->lock);
+  if (journal->len + len > journal->size)
+  {
+    if (!(aux = (unsigned char *)realloc(journal->buf, 2 * journal->size)))
+    {
+      pthread_mutex_unlock(&journal->lock);
+      return ERROR;
+    }
+    journal->buf = aux;
+    journal->size *= 2;
+  }
+  memcpy(journal->buf + journal->len, record, len);
+  if (journal->len == 0)
+    pthread_cond_signal(&journal->wake); /* The writer may be idle */
+  journal->len += len;
+  pthread_mutex_unlock(&journal->lock);
+
+  return OK;
+}
+
+/**
+* @brief Replays a journal
+*
+* journal_replay decodes every record of a journal and passes the
+* commands to a function and the checkpoints to another one. It stops
+* at a record cut by a crash, and it does not change the file. The
+* commands a snapshot already has are skipped, with their checkpoints
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param path is the file of the journal, it is fine if it does not exist
+* @param from is the number of commands skipped
+* @param apply is the function called with every command
+* @param check is the function called with every checkpoint, it can be
+* NULL; if it returns ERROR the replay stops there
+* @param data is passed to the functions
+* @param n is where the number of commands replayed is stored
+* @return ERROR if the file can not be read, is not a journal or has
+* fewer commands than the ones skipped
+*/
+STATUS journal_replay(const char *path, unsigned long from, journal_apply_fn apply, journal_check_fn check,
+                      void *data, unsigned long *n)
+{
+  unsigned char *buf = NULL;
+  Command command;
+  unsigned long hash = 0, skipped = 0;
+  size_t pos = JOURNAL_MAGIC_LEN, len = 0, got = 0;
+  int fd = -1;
+
+  if (!path || !apply || !n)
+    return ERROR;
+
+  *n = 0;
+  if ((fd = open(path, O_RDONLY)) == -1)
+    return (errno == ENOENT && from == 0) ? OK : ERROR;
+
+  buf = journal_read_all(fd, &len);
+  close(fd);
+  if (!buf)
+    return ERROR;
+
+  if (len > 0 && (len < JOURNAL_MAGIC_LEN || memcmp(buf, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN)))
+  {
+    free(buf);
+    return ERROR;
+  }
+
+  while (pos < len && (got = journal_decode(buf + pos, len - pos, &command, &hash)))
+  {
+    pos += got;
+    if (command.cmd != NO_CMD && skipped < from)
+    {
+      skipped++;
+    }
+    else if (command.cmd != NO_CMD)
+    {
+      apply(data, &command);
+      (*n)++;
+    }
+    else if (skipped == from && check && check(data, hash) == ERROR)
+    {
+      break;
+    }
+  }
+
+  free(buf);
+  return (skipped == from) ? OK : ERROR;
+}
+
+/**
+* @brief Encodes a command
+*
+* journal_encode writes the record of a command. An argument made only
+* of digits is stored as a number, any other one as a text
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param command is the command
+* @param buf is where the record is written, JOURNAL_RECORD_MAX bytes
+* @return the length of the record
+*/
+size_t journal_encode(const Command *command, unsigned char *buf)
+{
+  size_t arg_len = 0, i = 0, len = 1;
+  unsigned long value = 0;
+
+  buf[0] = (unsigned char)(command->cmd & JOURNAL_CMD_MASK);
+  arg_len = strlen(command->arg);
+  if (arg_len == 0)
+    return len;
+
+  /* Leading zeros would not be kept by a number */
+  for (i = 0; i < arg_len && command->arg[i] >= '0' && command->arg[i] <= '9'; i++)
+    value = value * 10 + (command->arg[i] - '0');
+  if (i == arg_len && arg_len <= JOURNAL_MAX_DIGITS && (arg_len == 1 || command->arg[0] != '0'))
+  {
+    buf[0] |= JOURNAL_NUMBER;
+    return len + journal_put_varint(value, buf + len);
+  }
+
+  buf[0] |= JOURNAL_TEXT;
+  len += journal_put_varint(arg_len, buf + len);
+  memcpy(buf + len, command->arg, arg_len);
+
+  return len + arg_len;
+}
+
+/**
+* @brief Encodes a checkpoint
+*
+* journal_encode_check writes the record of a checkpoint, the
+* hash lowest byte first
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param hash is the hash of the state
+* @param buf is where the record is written, JOURNAL_CHECK_LEN bytes
+* @return the length of the record
+*/
+size_t journal_encode_check(unsigned long hash, unsigned char *buf)
+{
+  int i = 0;
+
+  buf[0] = JOURNAL_CHECK;
+  for (i = 1; i < JOURNAL_CHECK_LEN; i++, hash >>= 8)
+    buf[i] = (unsigned char)(hash & 0xff);
+
+  return JOURNAL_CHECK_LEN;
+}
+
+/**
+* @brief Decodes a command
+*
+* journal_decode reads the record of a command, or of a checkpoint,
+* which is returned as NO_CMD with its hash
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is the record
+* @param len is the number of bytes available
+* @param command is where the command is stored
+* @param hash is where the hash of a checkpoint is stored
+* @return the length of the record or 0 if it is not whole or not valid
+*/
+size_t journal_decode(const unsigned char *buf, size_t len, Command *command, unsigned long *hash)
+{
+  unsigned long value = 0;
+  size_t pos = 1, n = 0;
+  int i = 0;
+  char digits[JOURNAL_MAX_DIGITS + 2];
+
+  if (len > 0 && buf[0] == JOURNAL_CHECK)
+  {
+    if (len < JOURNAL_CHECK_LEN)
+      return 0;
+    command->cmd = NO_CMD;
+    command->arg[0] = '\0';
+    for (*hash = 0, i = 8; i > 0; i--)
+      *hash = (*hash << 8) | buf[i];
+    return JOURNAL_CHECK_LEN;
+  }
+
+  if (len == 0 || (buf[0] & JOURNAL_CMD_MASK) >= N_COMMANDS)
+    return 0;
+
+  command->cmd = (T_Command)(buf[0] & JOURNAL_CMD_MASK);
+  command->arg[0] = '\0';
+
+  if (buf[0] & JOURNAL_NUMBER)
+  {
+    if (!(n = journal_get_varint(buf + pos, len - pos, &value)))
+      return 0;
+    i = sizeof(digits) - 1;
+    digits[i] = '\0';
+    do
+    {
+      digits[--i] = '0' + value % 10;
+      value /= 10;
+    } while (value && i > 0);
+    strcpy(command->arg, digits + i);
+    return pos + n;
+  }
+
+  if (buf[0] & JOURNAL_TEXT)
+  {
+    if (!(n = journal_get_varint(buf + pos, len - pos, &value)) || value >= CMD_ARG_SIZE || pos + n + value > len)
+      return 0;
+    pos += n;
+    memcpy(command->arg, buf + pos, value);
+    command->arg[value] = '\0';
+    return pos + value;
+  }
+
+  return pos;
+}
+
+/**
+* @brief The writer thread
+*
+* journal_writer writes in one go every record appended while it was
+* writing the previous ones, and fsyncs when the interval has passed,
+* waking up for it even if no more records come
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param arg is the journal
+* @return NULL
+*/
+void *journal_writer(void *arg)
+{
+  Journal *journal = (Journal *)arg;
+  unsigned char *aux = NULL;
+  size_t len = 0, size = 0;
+  struct timespec last_sync, deadline;
+  BOOL dirty = FALSE, closing = FALSE;
+  long wait_ms = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &last_sync);
+
+  pthread_mutex_lock(&journal->lock);
+  while (TRUE)
+  {
+    while (journal->len == 0 && !journal->closing)
+    {
+      if (!dirty || journal->fsync_ms <= 0)
+      {
+        pthread_cond_wait(&journal->wake, &journal->lock);
+        continue;
+      }
+      if ((wait_ms = journal->fsync_ms - journal_ms_since(&last_sync)) <= 0)
+        break; /* Time to fsync what was written */
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_sec += wait_ms / 1000;
+      deadline.tv_nsec += (wait_ms % 1000) * 1000000L;
+      if (deadline.tv_nsec >= 1000000000L)
+      {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+      }
+      pthread_cond_timedwait(&journal->wake, &journal->lock, &deadline);
+    }
+
+    /* Swap the buffers, so the game keeps appending while this one is written */
+    aux = journal->buf;
+    size = journal->size;
+    len = journal->len;
+    journal->buf = journal->spare;
+    journal->size = journal->spare_size;
+    journal->len = 0;
+    journal->spare = aux;
+    journal->spare_size = size;
+    closing = journal->closing;
+    pthread_mutex_unlock(&journal->lock);
+
+    if (len > 0)
+    {
+      if (journal_write_all(journal->fd, journal->spare, len) == ERROR)
+        journal->failed = TRUE;
+      dirty = TRUE;
+    }
+    if (dirty && journal->fsync_ms >= 0 &&
+        (closing || journal->fsync_ms == 0 || journal_ms_since(&last_sync) >= journal->fsync_ms))
+    {
+      if (fsync(journal->fd) == -1)
+        journal->failed = TRUE;
+      clock_gettime(CLOCK_MONOTONIC, &last_sync);
+      dirty = FALSE;
+    }
+
+    pthread_mutex_lock(&journal->lock);
+    if (closing && journal->len == 0)
+      break;
+  }
+  pthread_mutex_unlock(&journal->lock);
+
+  return NULL;
+}
+
+/**
+* @brief Writes a whole buffer
+*
+* journal_write_all writes again after a short write or a signal
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fd is the descriptor
+* @param buf is the buffer
+* @param len is the number of bytes
+* @return ERROR if the write failed
+*/
+STATUS journal_write_all(int fd, const unsigned char *buf, size_t len)
+{
+  ssize_t n = 0;
+
+  while (len > 0)
+  {
+    if ((n = write(fd, buf, len)) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      return ERROR;
+    }
+    buf += n;
+    len -= n;
+  }
+
+  return OK;
+}
+
+/**
+* @brief Reads a whole file
+*
+* journal_read_all reads a file from its beginning
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fd is the descriptor
+* @param len is where the number of bytes read is stored
+* @return the bytes, to be freed, or NULL if they could not be read
+*/
+unsigned char *journal_read_all(int fd, size_t *len)
+{
+  unsigned char *buf = NULL;
+  struct stat st;
+  ssize_t n = 0;
+
+  *len = 0;
+  if (fstat(fd, &st) == -1 || !(buf = (unsigned char *)malloc(st.st_size + 1)))
+    return NULL;
+
+  while (*len < (size_t)st.st_size)
+  {
+    if ((n = pread(fd, buf + *len, st.st_size - *len, *len)) > 0)
+      *len += n;
+    else if (n == 0)
+      break;
+    else if (errno != EINTR)
+    {
+      free(buf);
+      return NULL;
+    }
+  }
+
+  return buf;
+}
+
+/**
+* @brief Prepares a file to append records
+*
+* journal_repair writes the header to an empty file, or removes the
+* record cut at the end of a journal
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fd is the descriptor, open to read and write
+* @return ERROR if the file is not a journal or can not be changed
+*/
+STATUS journal_repair(int fd)
+{
+  unsigned char *buf = NULL;
+  Command command;
+  unsigned long hash = 0;
+  size_t pos = JOURNAL_MAGIC_LEN, len = 0, n = 0;
+  STATUS status = OK;
+
+  if (!(buf = journal_read_all(fd, &len)))
+    return ERROR;
+
+  if (len == 0)
+  {
+    status = journal_write_all(fd, (const unsigned char *)JOURNAL_MAGIC, JOURNAL_MAGIC_LEN);
+  }
+  else if (len < JOURNAL_MAGIC_LEN || memcmp(buf, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN))
+  {
+    status = ERROR; /* Not a journal, it is not touched */
+  }
+  else
+  {
+    while (pos < len && (n = journal_decode(buf + pos, len - pos, &command, &hash)))
+      pos += n;
+    if (pos < len && ftruncate(fd, pos) == -1)
+      status = ERROR;
+  }
+
+  free(buf);
+  return status;
+}
+
+/**
+* @brief Encodes a varint
+*
+* journal_put_varint writes a number seven bits per byte, lowest first,
+* with the high bit set in every byte but the last one
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param value is the number
+* @param buf is where it is written, up to 10 bytes
+* @return the number of bytes written
+*/
+size_t journal_put_varint(unsigned long value, unsigned char *buf)
+{
+  size_t n = 0;
+
+  while (value >= 0x80)
+  {
+    buf[n++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  buf[n++] = (unsigned char)value;
+
+  return n;
+}
+
+/**
+* @brief Decodes a varint
+*
+* journal_get_varint reads a number written by journal_put_varint
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param buf is the varint
+* @param len is the number of bytes available
+* @param value is where the number is stored
+* @return the number of bytes read or 0 if it is not whole
+*/
+size_t journal_get_varint(const unsigned char *buf, size_t len, unsigned long *value)
+{
+  size_t n = 0;
+  int shift = 0;
+
+  *value = 0;
+  for (n = 0; n < len && shift < 64; n++, shift += 7)
+  {
+    *value |= (unsigned long)(buf[n] & 0x7f) << shift;
+    if (!(buf[n] & 0x80))
+      return n + 1;
+  }
+
+  return 0;
+}
+
+/**
+* @brief Measures the time passed
+*
+* journal_ms_since gets the milliseconds passed since a time
+* of the monotonic clock
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param since is the time
+* @return the milliseconds passed
+*/
+long journal_ms_since(const struct timespec *since)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - since->tv_sec) * 1000 + (now.tv_nsec - since->tv_nsec) / 1000000;
+}
@@ -0,0 +1,41 @@
+/**
+ * @brief It defines the journal of the commands of a session
+ *
+ * @file journal.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "types.h"
+#include "command.h"
+
+#define JOURNAL_FSYNC_MS 100  /* Default time between two fsync */
+#define JOURNAL_RECORD_MAX 48 /* Command byte, varint length and argument */
+#define JOURNAL_CHECKPOINT 1024 /* Commands between two checkpoints */
+
+typedef struct _Journal Journal;
+
+/**
+   Function type of what is done with every command replayed
+*/
+typedef STATUS (*journal_apply_fn)(void *data, const Command *command);
+
+/**
+   Function type of what is done with the hash of every checkpoint
+*/
+typedef STATUS (*journal_check_fn)(void *data, unsigned long hash);
+
+Journal *journal_open(const char *path, long fsync_ms);
+STATUS journal_close(Journal *journal);
+STATUS journal_append(Journal *journal, const Command *command, unsigned long hash);
+STATUS journal_checkpoint(Journal *journal, unsigned long hash);
+STATUS journal_replay(const char *path, unsigned long from, journal_apply_fn apply, journal_check_fn check,
+                      void *data, unsigned long *n);
+size_t journal_encode(const Command *command, unsigned char *buf);
+size_t journal_decode(const unsigned char *buf, size_t len, Command *command, unsigned long *hash);
+
+#endif
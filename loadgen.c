@@ -0,0 +1,922 @@
+/**
+ * @brief It measures how many players at once oca can serve
+ *
+ * The load generator plays many sessions at once, on an oca-server
+ * over TCP or a Unix socket, or with --spawn on oca processes of their
+ * own over pipes. Every session sends a command, waits for the frame
+ * it paints, or for its message with --delta, and sends the next one
+ * at the rate asked for, so the time from a command to its frame is
+ * the latency a player sees. The commands are the lines of a script,
+ * every session starting at another line, or else random ones.
+ *
+ * The commands of a session are due at a fixed rate whether or not
+ * the frame of the last one came in time, and the latency counts from
+ * when a command was due, not from when it could be sent, so a slow
+ * server is not hidden by the commands it delays.
+ *
+ * The load runs in stages. After every stage the sessions, the commands
+ * per second and the 50th, 99th and 99.9th percentiles of the latency
+ * are printed, and with --slo-ms the next stage adds --step sessions,
+ * until the 99th percentile is over the SLO or --max-sessions is
+ * reached.
+ *
+ * @file loadgen.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "timer_wheel.h"
+#include "delta.h"
+
+#define LOADGEN_SESSIONS 10        /* Default sessions of the first stage */
+#define LOADGEN_RATE 10            /* Default commands per second of a session */
+#define LOADGEN_STAGE_MS 5000      /* Default length of a stage */
+#define LOADGEN_MAX_SESSIONS 10000 /* Default limit of sessions when ramping */
+#define LOADGEN_EVENTS 256         /* Events taken from epoll at once */
+#define LOADGEN_READ_SIZE 65536    /* Bytes read from a session at once */
+#define LOADGEN_LINE_MAX 128       /* Longest line of a script */
+#define LOADGEN_MARK "prompt:> "   /* End of a painted frame */
+#define LOADGEN_MARK_LEN 9
+
+/**
+ * @brief A session played by the load generator
+ */
+typedef struct _Loadgen_session
+{
+  int fd;                  /*!< Where the frames are read from */
+  int in;                  /*!< Where the commands are written, the socket or a pipe */
+  pid_t pid;               /*!< Its oca process, -1 if it plays on a server */
+  Timer timer;             /*!< Sends the next command */
+  BOOL greeted;            /*!< Whether the first frame has come */
+  BOOL waiting;            /*!< Whether a command waits for its frame */
+  BOOL dead;               /*!< Whether it failed and is not played any more */
+  unsigned long due;       /*!< When the last command sent was due, in microseconds */
+  long line;               /*!< Next line of the script */
+  unsigned int seed;       /*!< State of its random commands */
+  char tail[LOADGEN_MARK_LEN]; /*!< Last bytes received, as a frame may end across reads */
+  size_t tail_len;         /*!< Number of those bytes */
+  unsigned char buf[DELTA_MESSAGE_MAX]; /*!< Start of a message not received whole */
+  size_t len;              /*!< Bytes of that start */
+  Game_state state;        /*!< State decoded, only to follow the messages */
+  unsigned long fingerprint; /*!< Fingerprint of the world of the server */
+} Loadgen_session;
+
+/**
+ * @brief The load generator
+ */
+typedef struct _Loadgen
+{
+  int epoll;                  /*!< The epoll instance */
+  Timer_wheel *timers;        /*!< Timers of the sessions and of the stages, in milliseconds */
+  Timer stage;                /*!< Ends the stage */
+  BOOL stage_over;            /*!< Whether the stage has ended */
+  Loadgen_session **sessions; /*!< The sessions */
+  long n_sessions;            /*!< Number of sessions */
+  int port;                   /*!< TCP port of the server, -1 if none */
+  const char *unix_path;      /*!< Unix socket of the server, NULL if none */
+  const char *spawn;          /*!< Game data file of the oca processes, NULL if none */
+  const char *oca;            /*!< Path of the oca executable */
+  BOOL delta;                 /*!< Whether the server speaks the binary protocol */
+  char **script;              /*!< Lines of the script, NULL for random commands */
+  long script_len;            /*!< Number of lines of the script */
+  unsigned long interval;     /*!< Time between two commands of a session, in microseconds, 0 for none */
+  unsigned long *latencies;   /*!< Latencies of the stage, in microseconds */
+  size_t n_latencies;         /*!< Number of latencies of the stage */
+  size_t cap_latencies;       /*!< Room for latencies */
+  unsigned long failed;       /*!< Sessions failed, and latencies lost, in the stage */
+} Loadgen;
+
+/* Commands sent when there is no script, none of them exits */
+const char *loadgen_commands[] = {"n", "b", "t", "d", "m", "k", "j", "z", "y", "n 2", "b 2", "g 3"};
+
+volatile sig_atomic_t loadgen_stop = 0;
+
+void loadgen_on_signal(int signal);
+STATUS loadgen_read_script(Loadgen *loadgen, const char *path);
+STATUS loadgen_add_sessions(Loadgen *loadgen, long n);
+Loadgen_session *loadgen_open(Loadgen *loadgen);
+int loadgen_connect(Loadgen *loadgen);
+STATUS loadgen_spawn(Loadgen *loadgen, Loadgen_session *session);
+void loadgen_close(Loadgen_session *session);
+void loadgen_receive(Loadgen *loadgen, Loadgen_session *session);
+long loadgen_count_frames(Loadgen *loadgen, Loadgen_session *session, const unsigned char *buf, size_t len);
+void loadgen_answered(Loadgen *loadgen, Loadgen_session *session);
+void loadgen_on_timer(void *context, void *data);
+void loadgen_on_stage(void *context, void *data);
+void loadgen_send(Loadgen *loadgen, Loadgen_session *session);
+void loadgen_fail(Loadgen *loadgen, Loadgen_session *session);
+BOOL loadgen_report(Loadgen *loadgen, double seconds, long slo_ms);
+unsigned long loadgen_percentile(const unsigned long *sorted, size_t n, unsigned long permille);
+int loadgen_compare(const void *a, const void *b);
+unsigned long loadgen_now_us();
+
+int main(int argc, char *argv[])
+{
+  Loadgen loadgen;
+  struct sigaction action;
+  struct rlimit limit;
+  struct epoll_event events[LOADGEN_EVENTS];
+  const char *script_path = NULL;
+  unsigned long started = 0;
+  long sessions = LOADGEN_SESSIONS, step = 0, max_sessions = LOADGEN_MAX_SESSIONS;
+  long stage_ms = LOADGEN_STAGE_MS, slo_ms = 0, rate = LOADGEN_RATE, wait = 0, passed = 0, i = 0;
+  unsigned int seed = 1;
+  int n = 0, k = 0;
+  BOOL breached = FALSE;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "Use: %s (--port <port> | --unix <path> | --spawn <game_data_file> [--oca <path>]) [--delta]\n"
+                    "       [--sessions <n>] [--rate <commands per second>] [--script <file>] [--seed <n>]\n"
+                    "       [--stage-ms <ms>] [--slo-ms <ms> [--step <n>] [--max-sessions <n>]]\n", argv[0]);
+    return 1;
+  }
+
+  memset(&loadgen, 0, sizeof(loadgen));
+  loadgen.port = -1;
+  loadgen.oca = "./oca";
+  for (i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--port") && i + 1 < argc)
+      loadgen.port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--unix") && i + 1 < argc)
+      loadgen.unix_path = argv[++i];
+    else if (!strcmp(argv[i], "--spawn") && i + 1 < argc)
+      loadgen.spawn = argv[++i];
+    else if (!strcmp(argv[i], "--oca") && i + 1 < argc)
+      loadgen.oca = argv[++i];
+    else if (!strcmp(argv[i], "--delta"))
+      loadgen.delta = TRUE;
+    else if (!strcmp(argv[i], "--sessions") && i + 1 < argc)
+      sessions = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--rate") && i + 1 < argc)
+      rate = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--script") && i + 1 < argc)
+      script_path = argv[++i];
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+      seed = (unsigned int)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--stage-ms") && i + 1 < argc)
+      stage_ms = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--slo-ms") && i + 1 < argc)
+      slo_ms = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--step") && i + 1 < argc)
+      step = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--max-sessions") && i + 1 < argc)
+      max_sessions = atol(argv[++i]);
+    else
+    {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+  if ((loadgen.port >= 0) + (loadgen.unix_path != NULL) + (loadgen.spawn != NULL) != 1)
+  {
+    fprintf(stderr, "Give one of --port, --unix or --spawn.\n");
+    return 1;
+  }
+  if (loadgen.spawn && loadgen.delta)
+  {
+    fprintf(stderr, "The oca processes only paint frames, --delta is for a server.\n");
+    return 1;
+  }
+  if (sessions < 1 || stage_ms < 1)
+  {
+    fprintf(stderr, "There must be a session at least, and stages of a millisecond at least.\n");
+    return 1;
+  }
+  if (step < 1)
+    step = sessions;
+  loadgen.interval = rate > 0 ? 1000000UL / (unsigned long)rate : 0;
+  if (script_path && loadgen_read_script(&loadgen, script_path) == ERROR)
+  {
+    fprintf(stderr, "Error while reading the script %s.\n", script_path);
+    return 1;
+  }
+  srand(seed);
+
+  /* A descriptor or two per session, so take every descriptor allowed */
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+  {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = loadgen_on_signal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  action.sa_handler = SIG_IGN; /* A closed session is seen as EPIPE */
+  sigaction(SIGPIPE, &action, NULL);
+
+  if ((loadgen.epoll = epoll_create1(0)) == -1 ||
+      !(loadgen.timers = timer_wheel_create(loadgen_now_us() / 1000, &loadgen)))
+  {
+    fprintf(stderr, "Error while creating the event loop.\n");
+    return 1;
+  }
+  timer_init(&loadgen.stage, loadgen_on_stage, NULL);
+
+  printf("Sessions   Commands/s     p50 ms     p99 ms    p999 ms   Failed\n");
+  fflush(stdout);
+  while (!loadgen_stop)
+  {
+    if (loadgen_add_sessions(&loadgen, sessions - loadgen.n_sessions) == ERROR)
+    {
+      fprintf(stderr, "Error while opening the sessions: %s.\n", strerror(errno));
+      break;
+    }
+
+    /* A stage starts once every session has been opened */
+    timer_wheel_advance(loadgen.timers, loadgen_now_us() / 1000);
+    loadgen.n_latencies = 0;
+    loadgen.failed = 0;
+    loadgen.stage_over = FALSE;
+    timer_wheel_schedule(loadgen.timers, &loadgen.stage, (unsigned long)stage_ms);
+    started = loadgen_now_us();
+
+    while (!loadgen_stop && !loadgen.stage_over)
+    {
+      if ((wait = timer_wheel_next(loadgen.timers)) < 0 || wait > stage_ms)
+        wait = stage_ms;
+      if ((n = epoll_wait(loadgen.epoll, events, LOADGEN_EVENTS, (int)wait)) == -1 && errno != EINTR)
+      {
+        fprintf(stderr, "Error while waiting for events: %s.\n", strerror(errno));
+        loadgen_stop = 1;
+        break;
+      }
+      for (k = 0; k < n; k++)
+        loadgen_receive(&loadgen, (Loadgen_session *)events[k].data.ptr);
+      timer_wheel_advance(loadgen.timers, loadgen_now_us() / 1000);
+    }
+    if (!loadgen.stage_over)
+      break;
+
+    breached = loadgen_report(&loadgen, (loadgen_now_us() - started) / 1e6, slo_ms);
+    if (!slo_ms || breached || sessions >= max_sessions)
+      break;
+    passed = sessions;
+    sessions = sessions + step > max_sessions ? max_sessions : sessions + step;
+  }
+
+  if (slo_ms && breached)
+    printf("The 99th percentile went over %ld ms with %ld sessions, %ld sessions were within it\n", slo_ms,
+           sessions, passed);
+  else if (slo_ms && !loadgen_stop)
+    printf("The 99th percentile stayed within %ld ms up to %ld sessions\n", slo_ms, sessions);
+
+  timer_wheel_cancel(loadgen.timers, &loadgen.stage);
+  for (i = 0; i < loadgen.n_sessions; i++)
+  {
+    timer_wheel_cancel(loadgen.timers, &loadgen.sessions[i]->timer);
+    loadgen_close(loadgen.sessions[i]);
+  }
+  free(loadgen.sessions);
+  for (i = 0; i < loadgen.script_len; i++)
+    free(loadgen.script[i]);
+  free(loadgen.script);
+  free(loadgen.latencies);
+  timer_wheel_destroy(loadgen.timers);
+  close(loadgen.epoll);
+
+  return 0;
+}
+
+/**
+* @brief Asks the load generator to stop
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param signal is the signal
+*/
+void loadgen_on_signal(int signal)
+{
+  loadgen_stop = 1;
+}
+
+/**
+* @brief Reads the script of the sessions
+*
+* loadgen_read_script keeps every line of the file that is not empty
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param path is the path of the script
+* @return ERROR if it can not be read or it has no lines
+*/
+STATUS loadgen_read_script(Loadgen *loadgen, const char *path)
+{
+  FILE *file = NULL;
+  char line[LOADGEN_LINE_MAX];
+  char **script = NULL;
+  long cap = 0;
+  size_t len = 0;
+
+  if (!(file = fopen(path, "r")))
+    return ERROR;
+
+  while (fgets(line, sizeof(line), file))
+  {
+    len = strcspn(line, "\r\n");
+    line[len] = '\0';
+    if (!len)
+      continue;
+    if (loadgen->script_len == cap)
+    {
+      cap = cap ? 2 * cap : 64;
+      if (!(script = (char **)realloc(loadgen->script, cap * sizeof(char *))))
+        break;
+      loadgen->script = script;
+    }
+    if (!(loadgen->script[loadgen->script_len] = (char *)malloc(len + 1)))
+      break;
+    strcpy(loadgen->script[loadgen->script_len++], line);
+  }
+
+  fclose(file);
+  return loadgen->script_len > 0 ? OK : ERROR;
+}
+
+/**
+* @brief Opens more sessions
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param n is the number of sessions
+* @return ERROR if a session could not be opened
+*/
+STATUS loadgen_add_sessions(Loadgen *loadgen, long n)
+{
+  Loadgen_session **sessions = NULL;
+  Loadgen_session *session = NULL;
+
+  if (n <= 0)
+    return OK;
+  if (!(sessions = (Loadgen_session **)realloc(loadgen->sessions,
+                                                 (loadgen->n_sessions + n) * sizeof(Loadgen_session *))))
+    return ERROR;
+  loadgen->sessions = sessions;
+
+  for (; n > 0; n--)
+  {
+    if (!(session = loadgen_open(loadgen)))
+      return ERROR;
+    loadgen->sessions[loadgen->n_sessions++] = session;
+  }
+
+  return OK;
+}
+
+/**
+* @brief Opens a session
+*
+* loadgen_open connects to the server or starts an oca process, and
+* waits for the first frame before the session sends anything
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @return the new session or NULL if it could not be opened
+*/
+Loadgen_session *loadgen_open(Loadgen *loadgen)
+{
+  struct epoll_event event;
+  Loadgen_session *session = NULL;
+
+  if (!(session = (Loadgen_session *)calloc(1, sizeof(Loadgen_session))))
+    return NULL;
+  session->pid = -1;
+  session->fd = session->in = -1;
+  session->line = loadgen->script_len ? loadgen->n_sessions % loadgen->script_len : 0;
+  session->seed = (unsigned int)rand();
+  timer_init(&session->timer, loadgen_on_timer, session);
+
+  if (loadgen->spawn)
+  {
+    if (loadgen_spawn(loadgen, session) == ERROR)
+    {
+      free(session);
+      return NULL;
+    }
+  }
+  else if ((session->fd = session->in = loadgen_connect(loadgen)) == -1)
+  {
+    free(session);
+    return NULL;
+  }
+
+  event.events = EPOLLIN;
+  event.data.ptr = session;
+  if (epoll_ctl(loadgen->epoll, EPOLL_CTL_ADD, session->fd, &event) == -1)
+  {
+    loadgen_close(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+/**
+* @brief Connects to the server
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @return the socket, or -1 if it could not connect
+*/
+int loadgen_connect(Loadgen *loadgen)
+{
+  struct sockaddr_in in;
+  struct sockaddr_un un;
+  struct sockaddr *addr = NULL;
+  socklen_t len = 0;
+  int fd = -1;
+
+  if (loadgen->unix_path)
+  {
+    if (strlen(loadgen->unix_path) >= sizeof(un.sun_path))
+    {
+      errno = ENAMETOOLONG;
+      return -1;
+    }
+    memset(&un, 0, sizeof(un));
+    un.sun_family = AF_UNIX;
+    strcpy(un.sun_path, loadgen->unix_path);
+    addr = (struct sockaddr *)&un;
+    len = sizeof(un);
+  }
+  else
+  {
+    memset(&in, 0, sizeof(in));
+    in.sin_family = AF_INET;
+    in.sin_port = htons((unsigned short)loadgen->port);
+    in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr = (struct sockaddr *)&in;
+    len = sizeof(in);
+  }
+
+  if ((fd = socket(addr->sa_family, SOCK_STREAM, 0)) == -1)
+    return -1;
+  if (connect(fd, addr, len) == -1)
+  {
+    close(fd);
+    return -1;
+  }
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+  return fd;
+}
+
+/**
+* @brief Starts an oca process for a session
+*
+* loadgen_spawn runs oca with the game data file, writing the commands
+* to its input and reading the frames from its output
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param session is the session
+* @return the status
+*/
+STATUS loadgen_spawn(Loadgen *loadgen, Loadgen_session *session)
+{
+  int in[2], out[2], null = -1;
+
+  if (pipe(in) == -1)
+    return ERROR;
+  if (pipe(out) == -1)
+  {
+    close(in[0]);
+    close(in[1]);
+    return ERROR;
+  }
+
+  if ((session->pid = fork()) == 0)
+  {
+    dup2(in[0], STDIN_FILENO);
+    dup2(out[1], STDOUT_FILENO);
+    if ((null = open("/dev/null", O_WRONLY)) != -1)
+      dup2(null, STDERR_FILENO);
+    close(in[0]);
+    close(in[1]);
+    close(out[0]);
+    close(out[1]);
+    execl(loadgen->oca, loadgen->oca, loadgen->spawn, (char *)NULL);
+    _exit(127);
+  }
+
+  close(in[0]);
+  close(out[1]);
+  if (session->pid == -1)
+  {
+    close(in[1]);
+    close(out[0]);
+    return ERROR;
+  }
+  /* The processes started later do not keep the pipes of this one */
+  fcntl(in[1], F_SETFD, FD_CLOEXEC);
+  fcntl(out[0], F_SETFD, FD_CLOEXEC);
+  session->in = in[1];
+  session->fd = out[0];
+
+  return OK;
+}
+
+/**
+* @brief Closes a session
+*
+* loadgen_close closes its descriptors, which also takes it out of the
+* epoll, and waits for its oca process
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param session is the session
+*/
+void loadgen_close(Loadgen_session *session)
+{
+  if (session->in != -1 && session->in != session->fd)
+    close(session->in);
+  if (session->fd != -1)
+    close(session->fd);
+  if (session->pid > 0)
+  {
+    kill(session->pid, SIGTERM);
+    while (waitpid(session->pid, NULL, 0) == -1 && errno == EINTR)
+      ;
+  }
+  free(session);
+}
+
+/**
+* @brief Receives the frames of a session
+*
+* loadgen_receive reads what has come, and takes the first frame as
+* the greeting and any other as the answer to the command waiting
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param session is the session
+*/
+void loadgen_receive(Loadgen *loadgen, Loadgen_session *session)
+{
+  unsigned char buf[LOADGEN_READ_SIZE];
+  unsigned long now = 0, delay = 0;
+  ssize_t n = 0;
+  long frames = 0;
+
+  if (session->dead)
+    return;
+  while ((n = read(session->fd, buf, sizeof(buf))) == -1 && errno == EINTR)
+    ;
+  if (n <= 0 || (frames = loadgen_count_frames(loadgen, session, buf, (size_t)n)) < 0)
+  {
+    loadgen_fail(loadgen, session);
+    return;
+  }
+
+  for (; frames > 0; frames--)
+  {
+    if (!session->greeted)
+    {
+      session->greeted = TRUE;
+      /* The sessions start at random times, so they do not send together */
+      now = loadgen_now_us();
+      delay = loadgen->interval ? (unsigned long)rand_r(&session->seed) % loadgen->interval : 0;
+      session->due = now + delay;
+      timer_wheel_schedule(loadgen->timers, &session->timer, (delay + 999) / 1000);
+    }
+    else if (session->waiting)
+    {
+      loadgen_answered(loadgen, session);
+    }
+  }
+}
+
+/**
+* @brief Counts the frames received whole
+*
+* loadgen_count_frames finds the prompt that ends every painted frame,
+* or decodes the messages of the binary protocol
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param session is the session
+* @param buf is the bytes read
+* @param len is the number of bytes
+* @return the number of frames, or -1 if a message is not valid
+*/
+long loadgen_count_frames(Loadgen *loadgen, Loadgen_session *session, const unsigned char *buf, size_t len)
+{
+  unsigned char joined[2 * LOADGEN_MARK_LEN];
+  long frames = 0, message = 0;
+  size_t i = 0, n = 0, at = 0;
+
+  if (!loadgen->delta)
+  {
+    /* The prompt may have started in the last read */
+    n = len < LOADGEN_MARK_LEN ? len : LOADGEN_MARK_LEN;
+    memcpy(joined, session->tail, session->tail_len);
+    memcpy(joined + session->tail_len, buf, n);
+    for (i = 0; i < session->tail_len; i++)
+      if (i + LOADGEN_MARK_LEN <= session->tail_len + n && !memcmp(joined + i, LOADGEN_MARK, LOADGEN_MARK_LEN))
+        frames++;
+    for (i = 0; i + LOADGEN_MARK_LEN <= len; i++)
+      if (buf[i] == LOADGEN_MARK[0] && !memcmp(buf + i, LOADGEN_MARK, LOADGEN_MARK_LEN))
+        frames++;
+
+    /* What may be the start of the next prompt */
+    if (len >= LOADGEN_MARK_LEN - 1)
+    {
+      session->tail_len = LOADGEN_MARK_LEN - 1;
+      memcpy(session->tail, buf + len - session->tail_len, session->tail_len);
+    }
+    else
+    {
+      memcpy(joined, session->tail, session->tail_len);
+      memcpy(joined + session->tail_len, buf, len);
+      n = session->tail_len + len;
+      session->tail_len = n < LOADGEN_MARK_LEN - 1 ? n : LOADGEN_MARK_LEN - 1;
+      memcpy(session->tail, joined + n - session->tail_len, session->tail_len);
+    }
+    return frames;
+  }
+
+  while (at < len)
+  {
+    /* The start of a message is at most DELTA_MESSAGE_MAX bytes */
+    n = len - at < sizeof(session->buf) - session->len ? len - at : sizeof(session->buf) - session->len;
+    memcpy(session->buf + session->len, buf + at, n);
+    session->len += n;
+    at += n;
+    while ((message = delta_decode(session->buf, session->len, &session->state, &session->fingerprint)) > 0)
+    {
+      memmove(session->buf, session->buf + message, session->len - message);
+      session->len -= message;
+      frames++;
+    }
+    if (message < 0)
+      return -1;
+  }
+
+  return frames;
+}
+
+/**
+* @brief Takes the answer to the command waiting
+*
+* loadgen_answered keeps the latency of the command, from when it was
+* due, and sends the next one when it is due. A latency there is no
+* room for is counted as failed, and the session goes on
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param session is the session
+*/
+void loadgen_answered(Loadgen *loadgen, Loadgen_session *session)
+{
+  unsigned long *latencies = NULL;
+  unsigned long now = loadgen_now_us();
+  size_t cap = loadgen->cap_latencies ? 2 * loadgen->cap_latencies : 4096;
+
+  session->waiting = FALSE;
+  if (loadgen->n_latencies == loadgen->cap_latencies &&
+      (latencies = (unsigned long *)realloc(loadgen->latencies, cap * sizeof(unsigned long))))
+  {
+    loadgen->latencies = latencies;
+    loadgen->cap_latencies = cap;
+  }
+  if (loadgen->n_latencies < loadgen->cap_latencies)
+    loadgen->latencies[loadgen->n_latencies++] = now > session->due ? now - session->due : 0;
+  else
+    loadgen->failed++;
+
+  /* A command already due is sent at once, and its latency counts from then */
+  session->due = loadgen->interval ? session->due + loadgen->interval : now;
+  if (session->due <= now)
+    loadgen_send(loadgen, session);
+  else
+    timer_wheel_schedule(loadgen->timers, &session->timer, (session->due - now + 999) / 1000);
+}
+
+/**
+* @brief Sends the command of a session that is due
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the load generator
+* @param data is the session
+*/
+void loadgen_on_timer(void *context, void *data)
+{
+  Loadgen *loadgen = (Loadgen *)context;
+  Loadgen_session *session = (Loadgen_session *)data;
+  unsigned long now = loadgen_now_us();
+
+  /* The wheel counts whole milliseconds, so it may be a little early */
+  if (now < session->due)
+    timer_wheel_schedule(loadgen->timers, &session->timer, (session->due - now + 999) / 1000);
+  else
+    loadgen_send(loadgen, session);
+}
+
+/**
+* @brief Ends a stage
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the load generator
+* @param data is not used
+*/
+void loadgen_on_stage(void *context, void *data)
+{
+  ((Loadgen *)context)->stage_over = TRUE;
+}
+
+/**
+* @brief Sends the next command of a session
+*
+* loadgen_send writes the next line of the script, or a random command
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param session is the session
+*/
+void loadgen_send(Loadgen *loadgen, Loadgen_session *session)
+{
+  char line[LOADGEN_LINE_MAX + 1];
+  const char *command = NULL;
+  size_t len = 0, sent = 0;
+  ssize_t n = 0;
+
+  if (session->dead)
+    return;
+  if (loadgen->script_len)
+  {
+    command = loadgen->script[session->line];
+    session->line = (session->line + 1) % loadgen->script_len;
+  }
+  else
+  {
+    command = loadgen_commands[rand_r(&session->seed) % (sizeof(loadgen_commands) / sizeof(loadgen_commands[0]))];
+  }
+  len = strlen(command);
+  memcpy(line, command, len);
+  line[len++] = '\n';
+
+  for (sent = 0; sent < len; sent += n)
+  {
+    if ((n = write(session->in, line + sent, len - sent)) == -1)
+    {
+      if (errno == EINTR)
+      {
+        n = 0;
+        continue;
+      }
+      loadgen_fail(loadgen, session);
+      return;
+    }
+  }
+  session->waiting = TRUE;
+}
+
+/**
+* @brief Stops playing a session that failed
+*
+* loadgen_fail leaves the session out of the rest of the load, as
+* the server or its oca process has closed it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param session is the session
+*/
+void loadgen_fail(Loadgen *loadgen, Loadgen_session *session)
+{
+  session->dead = TRUE;
+  timer_wheel_cancel(loadgen->timers, &session->timer);
+  epoll_ctl(loadgen->epoll, EPOLL_CTL_DEL, session->fd, NULL);
+  loadgen->failed++;
+}
+
+/**
+* @brief Prints the results of a stage
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param loadgen is the load generator
+* @param seconds is the length of the stage
+* @param slo_ms is the limit of the 99th percentile, 0 for none
+* @return TRUE if the 99th percentile went over the limit, or a
+* session failed
+*/
+BOOL loadgen_report(Loadgen *loadgen, double seconds, long slo_ms)
+{
+  unsigned long p50 = 0, p99 = 0, p999 = 0;
+  size_t n = loadgen->n_latencies;
+
+  qsort(loadgen->latencies, n, sizeof(unsigned long), loadgen_compare);
+  p50 = loadgen_percentile(loadgen->latencies, n, 500);
+  p99 = loadgen_percentile(loadgen->latencies, n, 990);
+  p999 = loadgen_percentile(loadgen->latencies, n, 999);
+
+  printf("%8ld %12.1f %10.3f %10.3f %10.3f %8lu\n", loadgen->n_sessions, seconds > 0 ? n / seconds : 0.0,
+         p50 / 1e3, p99 / 1e3, p999 / 1e3, loadgen->failed);
+  fflush(stdout);
+
+  return slo_ms && (loadgen->failed || !n || p99 > (unsigned long)slo_ms * 1000) ? TRUE : FALSE;
+}
+
+/**
+* @brief Gets a percentile
+*
+* loadgen_percentile takes the nearest rank
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param sorted is the values, sorted
+* @param n is the number of values
+* @param permille is the percentile, in thousandths
+* @return the value, 0 if there are none
+*/
+unsigned long loadgen_percentile(const unsigned long *sorted, size_t n, unsigned long permille)
+{
+  if (!n)
+    return 0;
+  return sorted[(n * permille + 999) / 1000 - 1];
+}
+
+/**
+* @brief Compares two latencies for qsort
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param a is the first one
+* @param b is the second one
+* @return less than, equal to or greater than 0 as a is below, equal
+* to or above b
+*/
+int loadgen_compare(const void *a, const void *b)
+{
+  unsigned long x = *(const unsigned long *)a, y = *(const unsigned long *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/**
+* @brief Gets the time of a monotonic clock
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @return the time, in microseconds
+*/
+unsigned long loadgen_now_us()
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (unsigned long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
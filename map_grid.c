@@ -0,0 +1,416 @@
+/**
+ * @brief It implements a spatial index of the spaces in the map
+ *
+ * The layout is cut in square buckets of MAP_GRID_BUCKET cells and
+ * only the buckets holding a space are stored, in a hash table. A
+ * query walks the buckets covering the rectangle, so its cost depends
+ * on the size of the rectangle and not on the size of the world.
+ *
+ * @file map_grid.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdlib.h>
+#include "map_grid.h"
+
+/**
+ * @brief A bucket of the grid
+ *
+ * It stores the coordinates of the bucket and the first
+ * space inside it
+ */
+typedef struct _Bucket
+{
+  int bx, by; /*!< Coordinates of the bucket */
+  int head;   /*!< First entry in the bucket, -1 if the slot is free */
+} Bucket;
+
+/**
+ * @brief The structure of the grid
+ *
+ * It stores the spaces, chained by bucket, and the
+ * hash table of buckets
+ */
+struct _Map_grid
+{
+  Space **spaces;  /*!< Indexed spaces */
+  int *next;       /*!< Next entry in the same bucket, -1 if none */
+  int n, capacity; /*!< Number of indexed spaces and room for them */
+  Bucket *buckets; /*!< Hash table of buckets */
+  int mask;        /*!< Size of the hash table minus one */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+int map_grid_floor_div(int a, int b);
+Bucket *map_grid_bucket(Map_grid *grid, int bx, int by, BOOL create);
+void map_grid_place(Map_grid *grid, Space *space, int x, int y, int dx, int dy);
+
+/**
+* @brief Computes the creation of the grid
+*
+* map_grid_create creates an empty grid with room for a number of spaces
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param n_spaces is the number of spaces the grid will hold
+* @return the new grid or NULL if there is no memory
+*/
+Map_grid *map_grid_create(int n_spaces)
+{
+  Map_grid *grid = NULL;
+  int size = 1, i = 0;
+
+  if (n_spaces < 1)
+    n_spaces = 1;
+
+  /* At most one bucket per space, kept under half load */
+  while (size < 2 * n_spaces)
+    size <<= 1;
+
+  if (!(grid = (Map_grid *)calloc(1, sizeof(Map_grid))))
+    return NULL;
+
+  grid->spaces = (Space **)malloc(n_spaces * sizeof(Space *));
+  grid->next = (int *)malloc(n_spaces * sizeof(int));
+  grid->buckets = (Bucket *)malloc(size * sizeof(Bucket));
+  if (!grid->spaces || !grid->next || !grid->buckets)
+  {
+    map_grid_destroy(grid);
+    return NULL;
+  }
+
+  for (i = 0; i < size; i++)
+    grid->buckets[i].head = -1;
+
+  grid->capacity = n_spaces;
+  grid->mask = size - 1;
+
+  return grid;
+}
+
+/**
+* @brief Computes the destruction of the grid
+*
+* map_grid_destroy frees the grid, but not the spaces
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param grid is the grid which is going to be destroyed
+*/
+void map_grid_destroy(Map_grid *grid)
+{
+  if (!grid)
+    return;
+
+  free(grid->spaces);
+  free(grid->next);
+  free(grid->buckets);
+  free(grid);
+}
+
+/**
+* @brief Adds a space to the grid
+*
+* map_grid_add indexes the space at its position in the layout
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param grid is the grid
+* @param space is the space
+* @return the status
+*/
+STATUS map_grid_add(Map_grid *grid, Space *space)
+{
+  Bucket *bucket = NULL;
+  int x = 0, y = 0;
+
+  if (!grid || !space || grid->n >= grid->capacity)
+    return ERROR;
+
+  x = space_get_x(space);
+  y = space_get_y(space);
+  bucket = map_grid_bucket(grid, map_grid_floor_div(x, MAP_GRID_BUCKET),
+                           map_grid_floor_div(y, MAP_GRID_BUCKET), TRUE);
+  if (!bucket)
+    return ERROR;
+
+  grid->spaces[grid->n] = space;
+  grid->next[grid->n] = bucket->head;
+  bucket->head = grid->n;
+  grid->n++;
+
+  return OK;
+}
+
+/**
+* @brief gets the space at a position
+*
+* map_grid_get looks for the space placed at a cell of the layout
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param grid is the grid
+* @param x is the column
+* @param y is the row
+* @return the space or NULL if the cell is empty
+*/
+Space *map_grid_get(Map_grid *grid, int x, int y)
+{
+  Bucket *bucket = NULL;
+  int i = 0;
+
+  if (!grid)
+    return NULL;
+
+  bucket = map_grid_bucket(grid, map_grid_floor_div(x, MAP_GRID_BUCKET),
+                           map_grid_floor_div(y, MAP_GRID_BUCKET), FALSE);
+  if (!bucket)
+    return NULL;
+
+  for (i = bucket->head; i != -1; i = grid->next[i])
+  {
+    if (space_get_x(grid->spaces[i]) == x && space_get_y(grid->spaces[i]) == y)
+      return grid->spaces[i];
+  }
+
+  return NULL;
+}
+
+/**
+* @brief Looks for the spaces inside a rectangle
+*
+* map_grid_query only visits the buckets that cover the rectangle
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param grid is the grid
+* @param x0 is the first column of the rectangle
+* @param y0 is the first row of the rectangle
+* @param x1 is the last column of the rectangle
+* @param y1 is the last row of the rectangle
+* @param spaces is where the spaces found are stored
+* @param max is the room in spaces
+* @return the number of spaces found
+*/
+int map_grid_query(Map_grid *grid, int x0, int y0, int x1, int y1, Space **spaces, int max)
+{
+  Bucket *bucket = NULL;
+  int bx = 0, by = 0, i = 0, x = 0, y = 0, n = 0;
+
+  if (!grid || !spaces)
+    return 0;
+
+  for (by = map_grid_floor_div(y0, MAP_GRID_BUCKET); by <= map_grid_floor_div(y1, MAP_GRID_BUCKET); by++)
+  {
+    for (bx = map_grid_floor_div(x0, MAP_GRID_BUCKET); bx <= map_grid_floor_div(x1, MAP_GRID_BUCKET); bx++)
+    {
+      if (!(bucket = map_grid_bucket(grid, bx, by, FALSE)))
+        continue;
+
+      for (i = bucket->head; i != -1 && n < max; i = grid->next[i])
+      {
+        x = space_get_x(grid->spaces[i]);
+        y = space_get_y(grid->spaces[i]);
+        if (x >= x0 && x <= x1 && y >= y0 && y <= y1)
+          spaces[n++] = grid->spaces[i];
+      }
+    }
+  }
+
+  return n;
+}
+
+/**
+* @brief Computes the layout of the map
+*
+* map_grid_create_layout walks the links of the spaces breadth first
+* from the first one, placing each space next to the one it was reached
+* from in the direction of the link. If that cell is taken, the space is
+* moved further in the same direction. Spaces that cannot be reached are
+* laid out the same way to the right of the rest.
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param spaces is the list of spaces
+* @param n_spaces is the number of spaces
+* @return the grid indexing the positions or NULL if there is no memory
+*/
+Map_grid *map_grid_create_layout(Space **spaces, int n_spaces)
+{
+  Map_grid *grid = NULL;
+  Space *space = NULL;
+  Id *keys = NULL;
+  int *values = NULL, *queue = NULL;
+  char *placed = NULL;
+  int size = 1, first = 0, last = 0, start = 0, i = 0, d = 0, next = 0, max_x = -2;
+  unsigned long slot = 0;
+  Id link = NO_ID;
+  const int dx[4] = {0, 0, 1, -1};
+  const int dy[4] = {-1, 1, 0, 0};
+  Id (*links[4])(Space *);
+
+  links[0] = space_get_north;
+  links[1] = space_get_south;
+  links[2] = space_get_east;
+  links[3] = space_get_west;
+
+  while (size < 2 * n_spaces)
+    size <<= 1;
+
+  grid = map_grid_create(n_spaces);
+  keys = (Id *)malloc(size * sizeof(Id));
+  values = (int *)malloc(size * sizeof(int));
+  queue = (int *)malloc(size * sizeof(int));
+  placed = (char *)calloc(size, sizeof(char));
+  if (!grid || !keys || !values || !queue || !placed)
+  {
+    map_grid_destroy(grid);
+    grid = NULL;
+    n_spaces = 0;
+  }
+
+  /* Hash table from the id of each space to its position in the list */
+  for (i = 0; i < size && grid; i++)
+    keys[i] = NO_ID;
+  for (i = 0; i < n_spaces; i++)
+  {
+    slot = (unsigned long)space_get_id(spaces[i]) & (size - 1);
+    while (keys[slot] != NO_ID)
+      slot = (slot + 1) & (size - 1);
+    keys[slot] = space_get_id(spaces[i]);
+    values[slot] = i;
+  }
+
+  for (start = 0; start < n_spaces; start++)
+  {
+    if (placed[start])
+      continue;
+
+    map_grid_place(grid, spaces[start], max_x + 2, 0, 1, 0);
+    placed[start] = 1;
+    first = last = 0;
+    queue[last++] = start;
+
+    while (first < last)
+    {
+      space = spaces[queue[first++]];
+      if (space_get_x(space) > max_x)
+        max_x = space_get_x(space);
+
+      for (d = 0; d < 4; d++)
+      {
+        if ((link = links[d](space)) == NO_ID)
+          continue;
+
+        for (slot = (unsigned long)link & (size - 1); keys[slot] != NO_ID && keys[slot] != link;)
+          slot = (slot + 1) & (size - 1);
+        if (keys[slot] == NO_ID || placed[next = values[slot]])
+          continue;
+
+        map_grid_place(grid, spaces[next], space_get_x(space) + dx[d], space_get_y(space) + dy[d], dx[d], dy[d]);
+        placed[next] = 1;
+        queue[last++] = next;
+      }
+    }
+  }
+
+  free(keys);
+  free(values);
+  free(queue);
+  free(placed);
+
+  return grid;
+}
+
+/**
+* @brief Divides rounding towards minus infinity
+*
+* map_grid_floor_div is used so negative cells fall in the right bucket
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param a is the dividend
+* @param b is the divisor, greater than zero
+* @return the quotient
+*/
+int map_grid_floor_div(int a, int b)
+{
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+* @brief Looks for a bucket in the hash table
+*
+* map_grid_bucket finds the slot of a bucket, taking a free one
+* for it if it is not there and it has to be created
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param grid is the grid
+* @param bx is the column of the bucket
+* @param by is the row of the bucket
+* @param create is whether the bucket has to be created
+* @return the bucket or NULL if it is not there
+*/
+Bucket *map_grid_bucket(Map_grid *grid, int bx, int by, BOOL create)
+{
+  unsigned long hash = 0;
+  Bucket *bucket = NULL;
+
+  hash = ((unsigned long)bx * 73856093UL) ^ ((unsigned long)by * 19349663UL);
+
+  for (hash &= grid->mask;; hash = (hash + 1) & grid->mask)
+  {
+    bucket = &grid->buckets[hash];
+    if (bucket->head == -1)
+    {
+      if (!create)
+        return NULL;
+      bucket->bx = bx;
+      bucket->by = by;
+      return bucket;
+    }
+    if (bucket->bx == bx && bucket->by == by)
+      return bucket;
+  }
+}
+
+/**
+* @brief Places a space in the layout
+*
+* map_grid_place puts the space at the first free cell from a position
+* on, moving in a direction, and indexes it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param grid is the grid
+* @param space is the space
+* @param x is the preferred column
+* @param y is the preferred row
+* @param dx is the column step when the cell is taken
+* @param dy is the row step when the cell is taken
+*/
+void map_grid_place(Map_grid *grid, Space *space, int x, int y, int dx, int dy)
+{
+  while (map_grid_get(grid, x, y))
+  {
+    x += dx;
+    y += dy;
+  }
+
+  space_set_position(space, x, y);
+  map_grid_add(grid, space);
+}
@@ -0,0 +1,27 @@
+/**
+ * @brief It defines a spatial index of the spaces in the map
+ *
+ * @file map_grid.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef MAP_GRID_H
+#define MAP_GRID_H
+
+#include "types.h"
+#include "space.h"
+
+#define MAP_GRID_BUCKET 8
+
+typedef struct _Map_grid Map_grid;
+
+Map_grid *map_grid_create(int n_spaces);
+void map_grid_destroy(Map_grid *grid);
+STATUS map_grid_add(Map_grid *grid, Space *space);
+Space *map_grid_get(Map_grid *grid, int x, int y);
+int map_grid_query(Map_grid *grid, int x0, int y0, int x1, int y1, Space **spaces, int max);
+Map_grid *map_grid_create_layout(Space **spaces, int n_spaces);
+
+#endif
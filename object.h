@@ -1,27 +1,28 @@
-/** 
- * @brief It defines an object
- * 
- * @file object.h
- * @author David Ramirez
- * @version 1.0 
- * @date 18/02/2019
- */
-
-#ifndef OBJECT_H
-#define OBJECT_H
-
-#include "types.h"
-
-typedef struct _Object Object;
-
-#define MAX_OBJECTS 4
-
-Object *object_create(Id id);
-STATUS object_destroy(Object *object);
-STATUS object_set_id(Object *object, Id id);
-Id object_get_id(Object *object);
-const char *object_get_name(Object *object);
-STATUS object_set_name(Object *object, char *name);
-STATUS object_print(Object *object);
-
+/** 
+ * @brief It defines an object
+ * 
+ * @file object.h
+ * @author David Ramirez
+ * @version 1.0 
+ * @date 18/02/2019
+ */
+
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include "types.h"
+
+typedef struct _Object Object;
+
+#define MAX_OBJECTS 4
+#define OBJECT_NAME_SIZE 32 /* Longest name kept, longer ones are cut */
+
+Object *object_create(Id id);
+STATUS object_destroy(Object *object);
+STATUS object_set_id(Object *object, Id id);
+Id object_get_id(Object *object);
+const char *object_get_name(Object *object);
+STATUS object_set_name(Object *object, char *name);
+STATUS object_print(Object *object);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,255 @@
+/**
+ * @brief It implements the library to play the game inside another program
+ *
+ * A world of the library is the world the games share, and a renderer
+ * is a graphic engine, so only the sessions have a structure of their
+ * own: the game and the commands shown in its feedback area, which the
+ * graphic engine gets with every frame. The feedback gets a line for
+ * every command applied, so the frames are the ones oca paints.
+ *
+ * @file oca.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "oca.h"
+#include "game.h"
+#include "graphic_engine.h"
+#include "screen.h"
+
+#if OCA_FRAME_MAX < SCREEN_RENDER_MAX + 16
+#error "OCA_FRAME_MAX does not fit a frame and its prompt"
+#endif
+
+extern const char *const cmd_to_str[];
+
+/**
+ * @brief The structure of a session
+ */
+struct _Oca_session
+{
+  Game game;                 /*!< The game */
+  Graphic_feedback feedback; /*!< Commands shown in the feedback area */
+  BOOL over;                 /*!< Whether the game has finished */
+};
+
+/**
+* @brief Loads a world
+*
+* oca_world_load reads the spaces of a game data file
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param path is the game data file
+* @return the world or NULL if it could not be loaded
+*/
+Oca_world *oca_world_load(const char *path)
+{
+  if (!path)
+    return NULL;
+
+  /* The reader only opens the file, it does not change the path */
+  return (Oca_world *)world_create_from_file((char *)path);
+}
+
+/**
+* @brief Leaves a world
+*
+* oca_world_release gives up the world loaded. It is freed once the
+* sessions played on it are destroyed too
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+*/
+void oca_world_release(Oca_world *world)
+{
+  world_release((World *)world);
+}
+
+/**
+* @brief Computes the creation of a session
+*
+* oca_session_create starts a game on the world, which the session
+* keeps a reference to
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+* @return the new session or NULL if it could not be created
+*/
+Oca_session *oca_session_create(Oca_world *world)
+{
+  Oca_session *session = NULL;
+  Game_state state;
+
+  if (!world || !(session = (Oca_session *)calloc(1, sizeof(Oca_session))))
+    return NULL;
+
+  if (game_create_from_world(&session->game, (World *)world) == ERROR)
+  {
+    game_destroy(&session->game);
+    free(session);
+    return NULL;
+  }
+
+  /* The first frame shows there was no command yet, as in oca */
+  graphic_feedback_init(&session->feedback);
+  game_get_state(&session->game, &state);
+  graphic_feedback_add(&session->feedback, &state);
+
+  return session;
+}
+
+/**
+* @brief Computes the destruction of a session
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param session is the session
+*/
+void oca_session_destroy(Oca_session *session)
+{
+  if (!session)
+    return;
+
+  game_destroy(&session->game);
+  free(session);
+}
+
+/**
+* @brief Applies a command to a session
+*
+* oca_session_apply parses the line as if the player typed it, and
+* applies the command, so a word that is not a command is applied as
+* an unknown one. After the exit command, or when the game is over, no
+* more commands are applied
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param session is the session
+* @param line is the command and its argument, with or without the newline
+* @param len is the number of bytes of the line
+* @return OCA_OK, or OCA_ERROR if the line is blank or the game has
+* finished
+*/
+int oca_session_apply(Oca_session *session, const char *line, size_t len)
+{
+  Command command;
+  Game_state state;
+
+  if (!session || !line || session->over)
+    return OCA_ERROR;
+
+  while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+    len--;
+  if (command_parse(line, len, &command) == ERROR)
+    return OCA_ERROR;
+
+  game_update_command(&session->game, &command);
+  game_get_state(&session->game, &state);
+  graphic_feedback_add(&session->feedback, &state);
+  if (command.cmd == EXIT || game_is_over(&session->game))
+    session->over = TRUE;
+
+  return OCA_OK;
+}
+
+/**
+* @brief Gets the state of a session
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param session is the session
+* @param state is where the state is written
+* @return OCA_OK, or OCA_ERROR if an argument is missing
+*/
+int oca_session_get_state(Oca_session *session, Oca_state *state)
+{
+  Game_state game_state;
+
+  if (!session || !state)
+    return OCA_ERROR;
+
+  game_get_state(&session->game, &game_state);
+  state->player = game_state.player_location;
+  state->object = game_state.object_location;
+  state->carried = game_state.carried ? 1 : 0;
+  state->command = cmd_to_str[game_state.last_cmd - NO_CMD];
+  state->map = game_state.map_view ? 1 : 0;
+  state->scroll = game_state.scroll;
+  state->over = session->over ? 1 : 0;
+
+  return OCA_OK;
+}
+
+/**
+* @brief Paints a session to a buffer
+*
+* oca_session_render paints the frame oca would show for the session,
+* with the escape sequences of the terminal and the prompt. The frame
+* is not copied if the buffer is too small, OCA_FRAME_MAX bytes are
+* always enough
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param session is the session
+* @param renderer is the renderer, not used by another thread meanwhile
+* @param buf is where the frame is written
+* @param size is the bytes of the buffer
+* @return the bytes of the frame, or -1 if it could not be painted
+*/
+long oca_session_render(Oca_session *session, Oca_renderer *renderer, char *buf, size_t size)
+{
+  const char *frame = NULL;
+  Game_state state;
+  size_t len = 0;
+
+  if (!session || !renderer || !buf)
+    return -1;
+
+  game_get_state(&session->game, &state);
+  if (!(frame = graphic_engine_render_frame((Graphic_engine *)renderer, &session->game, &state,
+                                            &session->feedback, &len)))
+    return -1;
+  if (len <= size)
+    memcpy(buf, frame, len);
+
+  return (long)len;
+}
+
+/**
+* @brief Computes the creation of a renderer
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @return the new renderer or NULL if there is no memory
+*/
+Oca_renderer *oca_renderer_create()
+{
+  return (Oca_renderer *)graphic_engine_create();
+}
+
+/**
+* @brief Computes the destruction of a renderer
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param renderer is the renderer
+*/
+void oca_renderer_destroy(Oca_renderer *renderer)
+{
+  graphic_engine_destroy((Graphic_engine *)renderer);
+}
@@ -0,0 +1,71 @@
+/**
+ * @brief It defines the library to play the game inside another program
+ *
+ * liboca plays games without a process per player. A world is loaded
+ * once from a game data file and shared by every session played on
+ * it. A session is a game: the lines a player would type are applied
+ * to it, and its state can be queried or painted to a buffer by a
+ * renderer.
+ *
+ * Nothing is kept in global variables and nothing is written to the
+ * standard output. A world can be used by many threads at once, as it
+ * never changes after it is loaded. A session or a renderer is used by
+ * a single thread at a time, and a renderer paints any session, so one
+ * renderer per thread is enough.
+ *
+ * The header only needs the C library, so the types of the game are
+ * not seen by the program that uses it.
+ *
+ * @file oca.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef OCA_H
+#define OCA_H
+
+#include <stddef.h>
+
+#define OCA_OK 0
+#define OCA_ERROR -1
+#define OCA_FRAME_MAX 32800 /* Bytes of the longest frame painted */
+
+/* The library is built with the symbols hidden, only these are exported */
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define OCA_API __attribute__((visibility("default")))
+#else
+#define OCA_API
+#endif
+
+typedef struct _Oca_world Oca_world;
+typedef struct _Oca_session Oca_session;
+typedef struct _Oca_renderer Oca_renderer;
+
+/**
+ * @brief The state of a session
+ */
+typedef struct _Oca_state
+{
+  long player;         /*!< Id of the space where the player is */
+  long object;         /*!< Id of the space where the object is */
+  int carried;         /*!< Whether the player carries the object */
+  const char *command; /*!< Name of the last command applied */
+  int map;             /*!< Whether the whole map is shown */
+  int scroll;          /*!< Feedback lines scrolled back */
+  int over;            /*!< Whether the game has finished, no more commands are applied */
+} Oca_state;
+
+OCA_API Oca_world *oca_world_load(const char *path);
+OCA_API void oca_world_release(Oca_world *world);
+
+OCA_API Oca_session *oca_session_create(Oca_world *world);
+OCA_API void oca_session_destroy(Oca_session *session);
+OCA_API int oca_session_apply(Oca_session *session, const char *line, size_t len);
+OCA_API int oca_session_get_state(Oca_session *session, Oca_state *state);
+OCA_API long oca_session_render(Oca_session *session, Oca_renderer *renderer, char *buf, size_t size);
+
+OCA_API Oca_renderer *oca_renderer_create();
+OCA_API void oca_renderer_destroy(Oca_renderer *renderer);
+
+#endif
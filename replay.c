@@ -0,0 +1,247 @@
+/**
+ * @brief It replays recorded sessions and checks them
+ *
+ * Every recording is a journal written by the game. It is replayed on a
+ * fresh game as fast as possible, and at every checkpoint
+ * the hash of the state is compared with the recorded one, so the first
+ * place where the build stops behaving like the recording is reported.
+ * The recordings are shared between worker threads, one per core, and
+ * the world is loaded once and shared by all of their games.
+ *
+ * @file replay.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include "game.h"
+#include "journal.h"
+
+#define REPLAY_MAX_THREADS 64
+
+/**
+ * @brief The result of replaying a recording
+ */
+typedef struct _Replay_job
+{
+  const char *path;          /*!< File of the recording */
+  STATUS status;             /*!< ERROR if the world or the recording could not be read */
+  int error;                 /*!< errno if the recording could not be opened, or 0 */
+  unsigned long commands;    /*!< Commands replayed */
+  unsigned long checkpoints; /*!< Checkpoints that matched */
+  BOOL diverged;             /*!< Whether a checkpoint did not match */
+  unsigned long expected;    /*!< Hash recorded in the checkpoint that did not match */
+  unsigned long got;         /*!< Hash of the replayed state there */
+  unsigned long hash;        /*!< Hash of the final state */
+} Replay_job;
+
+/**
+ * @brief The recordings shared by the worker threads
+ */
+typedef struct _Replay_pool
+{
+  World *world;      /*!< The world, shared by every game */
+  Replay_job *jobs;  /*!< One job per recording */
+  int n_jobs;        /*!< Number of recordings */
+  int next;          /*!< Next job to take, taken atomically */
+} Replay_pool;
+
+/**
+ * @brief What a worker is replaying
+ */
+typedef struct _Replay_context
+{
+  Game game;        /*!< The world being replayed */
+  Replay_job *job;  /*!< The job being replayed */
+} Replay_context;
+
+void *replay_worker(void *arg);
+STATUS replay_apply(void *data, const Command *command);
+STATUS replay_check(void *data, unsigned long hash);
+
+int main(int argc, char *argv[])
+{
+  Replay_pool pool;
+  pthread_t threads[REPLAY_MAX_THREADS];
+  struct timespec start, end;
+  unsigned long total = 0;
+  double elapsed = 0;
+  long n_threads = 0;
+  int i = 0, first = 2, failed = 0;
+
+  if (argc > 3 && !strcmp(argv[2], "-j"))
+  {
+    n_threads = atol(argv[3]);
+    first = 4;
+  }
+  if (argc <= first)
+  {
+    fprintf(stderr, "Use: %s <game_data_file> [-j <threads>] <recording>...\n", argv[0]);
+    return 1;
+  }
+
+  if (n_threads < 1)
+    n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n_threads < 1)
+    n_threads = 1;
+  if (n_threads > REPLAY_MAX_THREADS)
+    n_threads = REPLAY_MAX_THREADS;
+  if (n_threads > argc - first)
+    n_threads = argc - first;
+
+  if (!(pool.world = world_create_from_file(argv[1])))
+  {
+    fprintf(stderr, "Error while loading the world.\n");
+    return 1;
+  }
+  pool.n_jobs = argc - first;
+  pool.next = 0;
+  if (!(pool.jobs = (Replay_job *)calloc(pool.n_jobs, sizeof(Replay_job))))
+  {
+    fprintf(stderr, "Error while allocating the recordings.\n");
+    return 1;
+  }
+  for (i = 0; i < pool.n_jobs; i++)
+    pool.jobs[i].path = argv[first + i];
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < n_threads; i++)
+    pthread_create(&threads[i], NULL, replay_worker, &pool);
+  for (i = 0; i < n_threads; i++)
+    pthread_join(threads[i], NULL);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  for (i = 0; i < pool.n_jobs; i++)
+  {
+    total += pool.jobs[i].commands;
+    if (pool.jobs[i].status == ERROR && pool.jobs[i].error)
+    {
+      printf("%s: ERROR, it could not be opened: %s\n", pool.jobs[i].path,
+             strerror(pool.jobs[i].error));
+      failed++;
+    }
+    else if (pool.jobs[i].status == ERROR)
+    {
+      printf("%s: ERROR, it could not be replayed\n", pool.jobs[i].path);
+      failed++;
+    }
+    else if (pool.jobs[i].diverged)
+    {
+      printf("%s: DIVERGED after command %lu, checkpoint %lu: expected %016lx, got %016lx\n",
+             pool.jobs[i].path, pool.jobs[i].commands, pool.jobs[i].checkpoints + 1,
+             pool.jobs[i].expected, pool.jobs[i].got);
+      failed++;
+    }
+    else
+    {
+      printf("%s: OK, %lu commands, %lu checkpoints, final hash %016lx\n", pool.jobs[i].path,
+             pool.jobs[i].commands, pool.jobs[i].checkpoints, pool.jobs[i].hash);
+    }
+  }
+
+  elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  printf("Recordings: %d, failed: %d, threads: %ld\n", pool.n_jobs, failed, n_threads);
+  printf("Commands: %lu in %.6f s, %.0f per second\n", total, elapsed, elapsed > 0 ? total / elapsed : 0.0);
+
+  free(pool.jobs);
+  world_release(pool.world);
+  return failed ? 1 : 0;
+}
+
+/**
+* @brief Replays recordings until there are none left
+*
+* replay_worker takes the next recording of the pool and replays
+* it on a new game on the world
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param arg is the pool
+* @return NULL
+*/
+void *replay_worker(void *arg)
+{
+  Replay_pool *pool = (Replay_pool *)arg;
+  Replay_context context;
+  int i = 0;
+
+  while ((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->n_jobs)
+  {
+    context.job = &pool->jobs[i];
+    /* A missing journal is a new session for the game, but not here */
+    if (access(context.job->path, R_OK) == -1)
+    {
+      context.job->error = errno;
+      context.job->status = ERROR;
+      continue;
+    }
+    if (game_create_from_world(&context.game, pool->world) == ERROR)
+    {
+      game_destroy(&context.game);
+      context.job->status = ERROR;
+      continue;
+    }
+
+    context.job->status = journal_replay(context.job->path, 0, replay_apply, replay_check,
+                                         &context, &context.job->commands);
+    context.job->hash = game_get_hash(&context.game);
+    game_destroy(&context.game);
+  }
+
+  return NULL;
+}
+
+/**
+* @brief Applies a command of a recording
+*
+* replay_apply is called for every command recorded
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param data is the context
+* @param command is the command
+* @return the status
+*/
+STATUS replay_apply(void *data, const Command *command)
+{
+  return game_update_command(&((Replay_context *)data)->game, command);
+}
+
+/**
+* @brief Checks a checkpoint of a recording
+*
+* replay_check compares the hash recorded with the one of the
+* replayed state, and stops the replay at the first difference
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param data is the context
+* @param hash is the hash recorded
+* @return ERROR if they are different
+*/
+STATUS replay_check(void *data, unsigned long hash)
+{
+  Replay_context *context = (Replay_context *)data;
+
+  if ((context->job->got = game_get_hash(&context->game)) != hash)
+  {
+    context->job->diverged = TRUE;
+    context->job->expected = hash;
+    return ERROR;
+  }
+
+  context->job->checkpoints++;
+  return OK;
+}
@@ -1,196 +1,337 @@
-/** 
- * @brief It defines a screen
- * 
- * @file screen.h
- * @author David Ramirez
- * @version 1.1
- * @date 18/02/2019
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#include "screen.h"
-
-#pragma GCC diagnostic ignored "-Wpedantic"
-
-#define ROWS 23
-#define COLUMNS 80
-#define TOTAL_DATA (ROWS * COLUMNS) + 1
-
-#define BG_CHAR '~'
-#define FG_CHAR ' '
-#define PROMPT " prompt:> "
-
-#define ACCESS(d, x, y) (d + ((y)*COLUMNS) + (x))
-
-/** 
- * @brief The structure of the screen
- *
- * It stores information of the area, 
- * such as the postion x, y; the width
- * and the height. It also stores the cursor 
- */
-struct _Area
-{
-  int x, y, width, height; /*!< Position x, y and width and height of the area */
-  char *cursor;            /*!< Cursor in the area */
-};
-
-char *__data;
-
-/****************************/
-/*     Private functions    */
-/****************************/
-int screen_area_cursor_is_out_of_bounds(Area *area);
-void screen_area_scroll_up(Area *area);
-void screen_utils_replaces_special_chars(char *str);
-
-/****************************/
-/* Functions implementation */
-/****************************/
-void screen_init()
-{
-  screen_destroy(); /* Dispose if previously initialized */
-  __data = (char *)malloc(sizeof(char) * TOTAL_DATA);
-
-  if (__data)
-  {
-    memset(__data, (int)BG_CHAR, TOTAL_DATA); /*Fill the background*/
-    *(__data + TOTAL_DATA - 1) = '\0';        /*NULL-terminated string*/
-  }
-}
-
-void screen_destroy()
-{
-  if (__data)
-    free(__data);
-}
-
-void screen_paint()
-{
-  char *src = NULL;
-  char dest[COLUMNS + 1];
-  int i = 0;
-
-  memset(dest, 0, COLUMNS + 1);
-
-  if (__data)
-  {
-    /* puts(__data); */ /*Dump data directly to the terminal*/
-    /*It works fine if the terminal window has the right size*/
-
-    puts("\033[2J"); /*Clear the terminal*/
-    for (src = __data; src < (__data + TOTAL_DATA - 1); src += COLUMNS)
-    {
-      memcpy(dest, src, COLUMNS);
-      /* printf("%s\n", dest); */
-      for (i = 0; i < COLUMNS; i++)
-      {
-        if (dest[i] == BG_CHAR)
-        {
-          printf("\033[0;34;44m%c\033[0m", dest[i]); /* fg:blue(34);bg:blue(44) */
-        }
-        else
-        {
-          printf("\033[0;30;47m%c\033[0m", dest[i]); /* fg:black(30);bg:white(47)*/
-        }
-      }
-      printf("\n");
-    }
-  }
-}
-
-void screen_gets(char *str)
-{
-  fprintf(stdout, PROMPT);
-  if (fgets(str, COLUMNS, stdin))
-    *(str + strlen(str) - 1) = 0; /* Replaces newline character with '\0' */
-}
-
-Area *screen_area_init(int x, int y, int width, int height)
-{
-  int i = 0;
-  Area *area = NULL;
-
-  if ((area = (Area *)malloc(sizeof(struct _Area))))
-  {
-    *area = (struct _Area){x, y, width, height, ACCESS(__data, x, y)};
-
-    for (i = 0; i < area->height; i++)
-      memset(ACCESS(area->cursor, 0, i), (int)FG_CHAR, (size_t)area->width);
-  }
-
-  return area;
-}
-
-void screen_area_destroy(Area *area)
-{
-  if (area)
-    free(area);
-}
-
-void screen_area_clear(Area *area)
-{
-  int i = 0;
-
-  if (area)
-  {
-    screen_area_reset_cursor(area);
-
-    for (i = 0; i < area->height; i++)
-      memset(ACCESS(area->cursor, 0, i), (int)FG_CHAR, (size_t)area->width);
-  }
-}
-
-void screen_area_reset_cursor(Area *area)
-{
-  if (area)
-    area->cursor = ACCESS(__data, area->x, area->y);
-}
-
-void screen_area_puts(Area *area, char *str)
-{
-  int len = 0;
-  char *ptr = NULL;
-
-  if (screen_area_cursor_is_out_of_bounds(area))
-    screen_area_scroll_up(area);
-
-  screen_utils_replaces_special_chars(str);
-
-  for (ptr = str; ptr < (str + strlen(str)); ptr += area->width)
-  {
-    memset(area->cursor, FG_CHAR, area->width);
-    len = (strlen(ptr) < area->width) ? strlen(ptr) : area->width;
-    memcpy(area->cursor, ptr, len);
-    area->cursor += COLUMNS;
-  }
-}
-
-int screen_area_cursor_is_out_of_bounds(Area *area)
-{
-  return area->cursor > ACCESS(__data,
-                               area->x + area->width,
-                               area->y + area->height - 1);
-}
-
-void screen_area_scroll_up(Area *area)
-{
-  for (area->cursor = ACCESS(__data, area->x, area->y);
-       area->cursor < ACCESS(__data, area->x + area->width, area->y + area->height - 2);
-       area->cursor += COLUMNS)
-  {
-    memcpy(area->cursor, area->cursor + COLUMNS, area->width);
-  }
-}
-
-void screen_utils_replaces_special_chars(char *str)
-{
-  char *pch = NULL;
-
-  /* Replaces acutes and tilde with '??' */
-  while ((pch = strpbrk(str, "ÁÉÍÓÚÑáéíóúñ")))
-    memcpy(pch, "??", 2);
-}
+/** 
+ * @brief It defines a screen
+ * 
+ * @file screen.h
+ * @author David Ramirez
+ * @version 1.1
+ * @date 18/02/2019
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "screen.h"
+
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#define ROWS 23
+#define COLUMNS 80
+#define TOTAL_DATA (ROWS * COLUMNS)
+
+#define BG_CHAR '~'
+#define FG_CHAR ' '
+#define WIDE_CHAR 0 /* Second column of a double width character */
+#define BAD_CHAR 0xFFFD /* Replacement for malformed UTF-8 */
+
+#define CLEAR "\033[2J"
+#define BG_COLOR "\033[0;34;44m" /* fg:blue(34);bg:blue(44) */
+#define FG_COLOR "\033[0;30;47m" /* fg:black(30);bg:white(47)*/
+#define RESET_COLOR "\033[0m"
+
+#define ACCESS(d, x, y) (d + ((y)*COLUMNS) + (x))
+
+/**
+ * @brief A character of the screen, as a Unicode code point
+ */
+typedef unsigned int Cell;
+
+/**
+ * @brief The structure of the screen
+ *
+ * It stores the characters of the whole screen. Every graphic
+ * engine paints on its own, so several can be used at once
+ */
+struct _Screen
+{
+  Cell data[TOTAL_DATA]; /*!< The characters, row by row */
+};
+
+/** 
+ * @brief The structure of the area
+ *
+ * It stores information of the area, 
+ * such as the postion x, y; the width
+ * and the height. It also stores the cursor 
+ */
+struct _Area
+{
+  int x, y, width, height; /*!< Position x, y and width and height of the area */
+  Cell *data;              /*!< Characters of the screen of the area */
+  Cell *cursor;            /*!< Cursor in the area */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+int screen_area_cursor_is_out_of_bounds(Area *area);
+void screen_area_scroll_up(Area *area);
+Cell *screen_area_new_row(Area *area);
+void screen_utils_fill(Cell *dest, Cell c, int n);
+int screen_utils_decode(const unsigned char *str, Cell *c);
+int screen_utils_char_width(Cell c);
+int screen_utils_encode(Cell c, char *dest);
+
+/****************************/
+/* Functions implementation */
+/****************************/
+Screen *screen_init()
+{
+  Screen *screen = NULL;
+
+  if ((screen = (Screen *)malloc(sizeof(Screen))))
+    screen_utils_fill(screen->data, BG_CHAR, TOTAL_DATA); /*Fill the background*/
+
+  return screen;
+}
+
+void screen_destroy(Screen *screen)
+{
+  free(screen);
+}
+
+size_t screen_render(Screen *screen, char *buf, size_t size)
+{
+  Cell *src = NULL;
+  char *dest = buf;
+  int i = 0, bg = -1, is_bg = 0;
+
+  if (!screen || !buf || size < SCREEN_RENDER_MAX)
+    return 0;
+
+  /* Clear the terminal, then emit the colour escape only when it changes
+     inside a row instead of once per character */
+  memcpy(dest, CLEAR "\n", sizeof(CLEAR));
+  dest += sizeof(CLEAR);
+
+  for (src = screen->data; src < (screen->data + TOTAL_DATA); src += COLUMNS)
+  {
+    bg = -1;
+    for (i = 0; i < COLUMNS; i++)
+    {
+      if (src[i] == WIDE_CHAR)
+        continue; /* Already painted by the previous column */
+
+      is_bg = (src[i] == BG_CHAR);
+      if (is_bg != bg)
+      {
+        memcpy(dest, is_bg ? BG_COLOR : FG_COLOR, sizeof(BG_COLOR) - 1);
+        dest += sizeof(BG_COLOR) - 1;
+        bg = is_bg;
+      }
+      dest += screen_utils_encode(src[i], dest);
+    }
+    memcpy(dest, RESET_COLOR "\n", sizeof(RESET_COLOR));
+    dest += sizeof(RESET_COLOR);
+  }
+
+  return (size_t)(dest - buf);
+}
+
+Area *screen_area_init(Screen *screen, int x, int y, int width, int height)
+{
+  int i = 0;
+  Area *area = NULL;
+
+  if (!screen)
+    return NULL;
+
+  if ((area = (Area *)malloc(sizeof(struct _Area))))
+  {
+    *area = (struct _Area){x, y, width, height, screen->data, ACCESS(screen->data, x, y)};
+
+    for (i = 0; i < area->height; i++)
+      screen_utils_fill(ACCESS(area->cursor, 0, i), FG_CHAR, area->width);
+  }
+
+  return area;
+}
+
+void screen_area_destroy(Area *area)
+{
+  free(area);
+}
+
+void screen_area_clear(Area *area)
+{
+  int i = 0;
+
+  if (area)
+  {
+    screen_area_reset_cursor(area);
+
+    for (i = 0; i < area->height; i++)
+      screen_utils_fill(ACCESS(area->cursor, 0, i), FG_CHAR, area->width);
+  }
+}
+
+void screen_area_reset_cursor(Area *area)
+{
+  if (area)
+    area->cursor = ACCESS(area->data, area->x, area->y);
+}
+
+void screen_area_puts(Area *area, const char *str)
+{
+  const unsigned char *ptr = (const unsigned char *)str;
+  Cell *row = NULL;
+  Cell c = 0;
+  int col = 0, width = 0;
+
+  if (!area || !str || !*str)
+    return;
+
+  row = screen_area_new_row(area);
+
+  /* One pass over the string, wrapping by display width */
+  while (*ptr)
+  {
+    ptr += screen_utils_decode(ptr, &c);
+    if ((width = screen_utils_char_width(c)) == 0 || width > area->width)
+      continue;
+
+    if (col + width > area->width)
+    {
+      row = screen_area_new_row(area);
+      col = 0;
+    }
+
+    row[col++] = c;
+    if (width == 2)
+      row[col++] = WIDE_CHAR;
+  }
+}
+
+int screen_area_cursor_is_out_of_bounds(Area *area)
+{
+  return area->cursor > ACCESS(area->data,
+                               area->x + area->width,
+                               area->y + area->height - 1);
+}
+
+void screen_area_scroll_up(Area *area)
+{
+  for (area->cursor = ACCESS(area->data, area->x, area->y);
+       area->cursor < ACCESS(area->data, area->x + area->width, area->y + area->height - 2);
+       area->cursor += COLUMNS)
+  {
+    memcpy(area->cursor, area->cursor + COLUMNS, area->width * sizeof(Cell));
+  }
+}
+
+Cell *screen_area_new_row(Area *area)
+{
+  Cell *row = NULL;
+
+  if (screen_area_cursor_is_out_of_bounds(area))
+    screen_area_scroll_up(area);
+  row = area->cursor;
+  area->cursor += COLUMNS;
+
+  screen_utils_fill(row, FG_CHAR, area->width);
+  return row;
+}
+
+void screen_utils_fill(Cell *dest, Cell c, int n)
+{
+  while (n-- > 0)
+    *dest++ = c;
+}
+
+int screen_utils_decode(const unsigned char *str, Cell *c)
+{
+  int len = 0, i = 0;
+  Cell min = 0;
+
+  if (str[0] < 0x80)
+  {
+    *c = str[0];
+    return 1;
+  }
+  else if ((str[0] & 0xE0) == 0xC0)
+  {
+    *c = str[0] & 0x1F;
+    len = 2;
+    min = 0x80;
+  }
+  else if ((str[0] & 0xF0) == 0xE0)
+  {
+    *c = str[0] & 0x0F;
+    len = 3;
+    min = 0x800;
+  }
+  else if ((str[0] & 0xF8) == 0xF0)
+  {
+    *c = str[0] & 0x07;
+    len = 4;
+    min = 0x10000;
+  }
+  else
+  {
+    *c = BAD_CHAR; /* Stray continuation byte */
+    return 1;
+  }
+
+  for (i = 1; i < len; i++)
+  {
+    if ((str[i] & 0xC0) != 0x80)
+    {
+      *c = BAD_CHAR; /* Truncated sequence, the next byte starts over */
+      return i;
+    }
+    *c = (*c << 6) | (str[i] & 0x3F);
+  }
+
+  if (*c < min || *c > 0x10FFFF || (*c >= 0xD800 && *c <= 0xDFFF))
+    *c = BAD_CHAR; /* Overlong or not a character */
+
+  return len;
+}
+
+int screen_utils_char_width(Cell c)
+{
+  /* Controls and combining marks take no column */
+  if (c < 0x20 || (c >= 0x7F && c < 0xA0) ||
+      (c >= 0x300 && c <= 0x36F) || (c >= 0x1AB0 && c <= 0x1AFF) ||
+      (c >= 0x1DC0 && c <= 0x1DFF) || (c >= 0x200B && c <= 0x200F) ||
+      (c >= 0x20D0 && c <= 0x20FF) || (c >= 0xFE20 && c <= 0xFE2F))
+    return 0;
+
+  /* East Asian wide and fullwidth characters take two */
+  if ((c >= 0x1100 && c <= 0x115F) || (c >= 0x2E80 && c <= 0xA4CF && c != 0x303F) ||
+      (c >= 0xAC00 && c <= 0xD7A3) || (c >= 0xF900 && c <= 0xFAFF) ||
+      (c >= 0xFE30 && c <= 0xFE4F) || (c >= 0xFF00 && c <= 0xFF60) ||
+      (c >= 0xFFE0 && c <= 0xFFE6) || (c >= 0x1F300 && c <= 0x1F64F) ||
+      (c >= 0x1F900 && c <= 0x1F9FF) || (c >= 0x20000 && c <= 0x3FFFD))
+    return 2;
+
+  return 1;
+}
+
+int screen_utils_encode(Cell c, char *dest)
+{
+  if (c < 0x80)
+  {
+    dest[0] = (char)c;
+    return 1;
+  }
+  else if (c < 0x800)
+  {
+    dest[0] = (char)(0xC0 | (c >> 6));
+    dest[1] = (char)(0x80 | (c & 0x3F));
+    return 2;
+  }
+  else if (c < 0x10000)
+  {
+    dest[0] = (char)(0xE0 | (c >> 12));
+    dest[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+    dest[2] = (char)(0x80 | (c & 0x3F));
+    return 3;
+  }
+
+  dest[0] = (char)(0xF0 | (c >> 18));
+  dest[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+  dest[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+  dest[3] = (char)(0x80 | (c & 0x3F));
+  return 4;
+}
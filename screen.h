@@ -1,29 +1,33 @@
-/** 
- * @brief It defines a screen
- * 
- * @file screen.h
- * @author Profesores PPROG
- * @version 1.0 
- * @date 11/01/2017
- * @copyright GNU Public License
- */
-
-#ifndef __SCREEN__
-#define __SCREEN__
-
-#define SCREEN_MAX_STR 80
-
-typedef struct _Area Area;
-
-void screen_init();
-void screen_destroy();
-void screen_paint();
-void screen_gets(char *str);
-
-Area *screen_area_init(int x, int y, int width, int height);
-void screen_area_destroy(Area *area);
-void screen_area_clear(Area *area);
-void screen_area_reset_cursor(Area *area);
-void screen_area_puts(Area *area, char *str);
-
-#endif
+/** 
+ * @brief It defines a screen
+ * 
+ * @file screen.h
+ * @author Profesores PPROG
+ * @version 1.0 
+ * @date 11/01/2017
+ * @copyright GNU Public License
+ */
+
+#ifndef __SCREEN__
+#define __SCREEN__
+
+#include <stddef.h>
+#include "types.h"
+
+#define SCREEN_MAX_STR 80
+#define SCREEN_RENDER_MAX 32768
+
+typedef struct _Screen Screen;
+typedef struct _Area Area;
+
+Screen *screen_init();
+void screen_destroy(Screen *screen);
+size_t screen_render(Screen *screen, char *buf, size_t size);
+
+Area *screen_area_init(Screen *screen, int x, int y, int width, int height);
+void screen_area_destroy(Area *area);
+void screen_area_clear(Area *area);
+void screen_area_reset_cursor(Area *area);
+void screen_area_puts(Area *area, const char *str);
+
+#endif
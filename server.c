@@ -0,0 +1,2249 @@
+/**
+ * @brief It serves many games at once over sockets
+ *
+ * Every connection, over TCP on localhost or over a Unix socket, gets
+ * its own game. A single thread waits for all of them with an edge
+ * triggered epoll and reads every socket until it would block. What
+ * it reads is handed to the session, and the session is given to a
+ * pool of workers, one per core, that steal work from each other.
+ *
+ * A session is queued or run by a single worker at a time, so its
+ * commands are applied in order. The worker applies all the commands
+ * read so far in a row, paints a single frame for them with its own
+ * graphic engine, and writes it at once if the socket takes it. The
+ * rest is kept, and written by the event loop when epoll says the
+ * socket is writable. Only the event loop closes sessions: a worker
+ * hands a finished session back to it through an eventfd.
+ *
+ * The output kept for a client has a budget of bytes. A client that
+ * does not read fast enough is not sent every frame: once its output
+ * is over the budget, the frames it has not started to get are
+ * dropped for the newest one, and a client of the binary protocol
+ * gets what changed since the last message it keeps. So a slow client
+ * holds little memory and never holds anyone else back. The frames
+ * dropped are counted for every client, and printed with the metrics.
+ *
+ * The world is loaded once and shared by every game, which only keeps
+ * its positions and its feedback lines between frames, and a connection
+ * that is not reading or writing has no buffers, so idle sessions are
+ * cheap. Sessions and their games are allocated from slabs of blocks of
+ * their size, which the event loop owns.
+ *
+ * A session that has not sent anything for a while hibernates: the event
+ * loop encodes its game in a few bytes, puts them aside in a spill file
+ * and frees the game, leaving only the socket and the session. The next
+ * time the client sends something the game is read back before its
+ * commands are applied, so the client does not notice.
+ *
+ * The event loop keeps the timers of every session in a timer wheel,
+ * and waits for events only until the next one expires. Every session
+ * has a timer to hibernate, a timer to close it when the client has
+ * not sent anything for --kick-ms, and with --turn-ms a timer that
+ * plays the turn for the player, who moves to the next space, when no
+ * command comes in time. Scheduling or cancelling a timer does not
+ * depend on the number of sessions, so the input of a client restarts
+ * its timers at no cost.
+ *
+ * The clients of the delta listeners get, instead of the painted frame,
+ * a few bytes with what changed in the state of their game, and paint
+ * the frame themselves (see delta.c and client.c).
+ *
+ * The clients of the watch listeners are spectators: they send the
+ * number of a session, counted from 1 in the order they connected, and
+ * then get every frame of its game. A frame is painted once for all the
+ * spectators of a session, in a buffer counted by reference, and every
+ * spectator keeps a reference to it until it has been written, with a
+ * single writev for all the frames it has waiting.
+ *
+ * @file server.c
+ * @author David Ramirez
+ * @version 1.1
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <time.h>
+#include "game.h"
+#include "graphic_engine.h"
+#include "executor.h"
+#include "slab.h"
+#include "spill.h"
+#include "timer_wheel.h"
+#include "delta.h"
+
+#define SERVER_PORT 7070          /* Default TCP port */
+#define SERVER_MAX_SESSIONS 10000 /* Default limit of sessions at once */
+#define SERVER_LISTENERS 6        /* A TCP and a Unix socket for each protocol and for the spectators */
+#define SERVER_EVENTS 256         /* Events taken from epoll at once */
+#define SERVER_READ_SIZE 4096     /* Bytes read from a socket at once */
+#define SERVER_LINE_MAX 128       /* Longest command line, longer ones are ignored */
+#define SERVER_INPUT_MAX (1L << 16)  /* Input kept for a client whose commands are not applied yet */
+#define SERVER_OUTPUT_BUDGET (1L << 16) /* Default output kept for a client before frames are dropped */
+#define SERVER_HIBERNATE_MS 60000 /* Default time without input before a session hibernates */
+#define SERVER_WAIT_MAX_MS 60000  /* Longest wait for events, the timers ask for less */
+#define SERVER_SLAB_PAGE 256      /* Sessions allocated at once */
+#define SERVER_SPECTATOR_FRAMES 16 /* Frames kept for a spectator that does not read */
+
+/* What the clients of a listener are */
+#define SERVER_TEXT 0  /* Players getting the painted frames */
+#define SERVER_DELTA 1 /* Players of the binary protocol */
+#define SERVER_WATCH 2 /* Spectators */
+
+/* Layout of a hibernated session, followed by its feedback, its line and its game */
+#define RECORD_FLAGS_AT 0    /* 1 byte */
+#define RECORD_FEEDBACK_AT 1 /* 1 byte, number of feedback lines */
+#define RECORD_LINE_AT 2     /* 1 byte, bytes of the line being parsed */
+#define RECORD_HEADER 3
+#define RECORD_PAINTED 1     /* Flags */
+#define RECORD_EXITED 2
+#define RECORD_DISCARDING 4
+#define RECORD_MAX (RECORD_HEADER + GRAPHIC_FEEDBACK_LINES + SERVER_LINE_MAX + GAME_ENCODED_MAX)
+
+/**
+ * @brief The game of a session
+ *
+ * It is only used by the worker running the session, and it is freed
+ * while the session hibernates
+ */
+typedef struct _Session_play
+{
+  Game game;                     /*!< Game of the client */
+  Graphic_feedback feedback;     /*!< Commands shown in the feedback area */
+  char line[SERVER_LINE_MAX];    /*!< Command line being parsed */
+  size_t line_len;               /*!< Bytes of the command line parsed so far */
+  BOOL discarding;               /*!< Whether the line is too long and skipped */
+  BOOL painted;                  /*!< Whether the first frame has been sent */
+  Game_state waiting_from;       /*!< State the messages waiting start from, for the binary protocol */
+  BOOL exited;                   /*!< Whether the exit command has been applied */
+} Session_play;
+
+/**
+ * @brief A painted frame shared by the spectators of a session
+ */
+typedef struct _Server_frame
+{
+  unsigned long refs; /*!< References to it, updated atomically */
+  size_t len;         /*!< Bytes of the frame */
+  char *data;         /*!< The frame, right after the structure */
+} Server_frame;
+
+/**
+ * @brief What a socket registered with epoll is
+ */
+typedef enum
+{
+  SERVER_SOURCE_WAKEUP,   /*!< The eventfd of the workers */
+  SERVER_SOURCE_LISTENER, /*!< A listening socket */
+  SERVER_SOURCE_SESSION,  /*!< The socket of a session */
+  SERVER_SOURCE_SPECTATOR /*!< The socket of a spectator */
+} Server_source_kind;
+
+/**
+ * @brief What the events of a socket are for, given to epoll
+ */
+typedef struct _Server_source
+{
+  Server_source_kind kind; /*!< What the socket is */
+  int listener;            /*!< Number of the listening socket */
+  void *owner;             /*!< The session or the spectator */
+} Server_source;
+
+struct _Spectator;
+
+/**
+ * @brief A connection and its game
+ *
+ * The lock guards the input, the output, the flags and the spectators,
+ * which are shared by the event loop and the worker running the
+ * session. The game and the command line being parsed are only used
+ * by that worker
+ */
+typedef struct _Session
+{
+  Server_source source;          /*!< What its epoll events are for */
+  int fd;                        /*!< Socket of the client */
+  pthread_mutex_t lock;          /*!< Guards the fields up to closing */
+  char *input;                   /*!< Bytes read and not applied yet, NULL if there are none */
+  size_t input_len;              /*!< Number of bytes of the input */
+  char *out;                     /*!< Frame being written, NULL if there is none */
+  size_t out_len;                /*!< Bytes of the frame */
+  size_t out_sent;               /*!< Bytes of the frame already written */
+  char *waiting;                 /*!< Frames waiting after it, NULL if there are none */
+  size_t waiting_len;            /*!< Bytes of the frames waiting */
+  unsigned long waiting_frames;  /*!< Number of frames waiting */
+  unsigned long dropped;         /*!< Frames dropped because the client was behind */
+  BOOL scheduled;                /*!< Whether a worker has it, queued or running */
+  BOOL returning;                /*!< Whether it is being handed back to the event loop */
+  BOOL dead;                     /*!< Whether it has to be closed at once */
+  BOOL closing;                  /*!< Whether it is closed when the output is written */
+  BOOL repaint;                  /*!< Whether a frame has to be painted for a new spectator */
+  BOOL delta;                    /*!< Whether the client speaks the binary protocol, it never changes */
+  struct _Spectator *spectators; /*!< Spectators watching it */
+  unsigned long number;          /*!< Number the spectators know it by, it never changes */
+  unsigned long timed_turns;     /*!< Turns to play for the client, as it took too long */
+  Session_play *play;            /*!< Its game, NULL while it hibernates */
+  long slot;                     /*!< Slot of its game in the spill file while it hibernates */
+  Timer sleep;                   /*!< Puts it to hibernate, for the event loop */
+  Timer kick;                    /*!< Closes it when the client is away, for the event loop */
+  Timer turn;                    /*!< Plays the turn when no command comes in time, for the event loop */
+  struct _Session *prev, *next;  /*!< Neighbours in its list of sessions, for the event loop */
+  struct _Session *returned;     /*!< Next session handed back to the event loop */
+  struct _Session *finished;     /*!< Next session waiting to be closed, for the event loop */
+  BOOL closing_later;            /*!< Whether it waits to be closed, for the event loop */
+} Session;
+
+/**
+ * @brief A connection watching the game of a session
+ *
+ * The lock guards the frames and the flags, which are shared by the
+ * event loop and the worker running the session watched. It is taken
+ * after the lock of that session. The session watched and the lists
+ * are only changed by the event loop, with the lock of the session
+ * held while it is linked to it
+ */
+typedef struct _Spectator
+{
+  Server_source source;          /*!< What its epoll events are for */
+  int fd;                        /*!< Socket of the spectator */
+  pthread_mutex_t lock;          /*!< Guards the frames and the flags */
+  Server_frame *frames[SERVER_SPECTATOR_FRAMES]; /*!< Frames not written yet, the oldest first */
+  int first;                     /*!< Position of the oldest frame */
+  int n_frames;                  /*!< Number of frames waiting */
+  size_t queued;                 /*!< Bytes of the frames waiting */
+  size_t sent;                   /*!< Bytes of the oldest frame already written */
+  unsigned long dropped;         /*!< Frames dropped because it was behind */
+  BOOL dead;                     /*!< Whether it has to be closed at once */
+  BOOL closing;                  /*!< Whether it is closed when its frames are written */
+  BOOL joining;                  /*!< Whether it has not been given a frame yet, guarded by the lock of the session */
+  Session *watched;              /*!< Session watched, NULL until its number is received */
+  unsigned long number;          /*!< Number of the session watched */
+  char line[SERVER_LINE_MAX];    /*!< Number of the session, being received */
+  size_t line_len;               /*!< Bytes of the number received so far */
+  struct _Spectator *prev, *next; /*!< Neighbours among the spectators of the session watched */
+  struct _Spectator *all_prev, *all_next; /*!< Neighbours among every spectator, for the event loop */
+  struct _Spectator *finished;   /*!< Next spectator waiting to be closed, for the event loop */
+  BOOL closing_later;            /*!< Whether it waits to be closed, for the event loop */
+} Spectator;
+
+/**
+ * @brief How many times something was done and how long it took
+ */
+typedef struct _Server_latency
+{
+  unsigned long count; /*!< Times done */
+  unsigned long failed; /*!< Times it could not be done */
+  double total_ms;     /*!< Time taken by all of them */
+  double max_ms;       /*!< Longest time taken */
+} Server_latency;
+
+/**
+ * @brief The server
+ */
+typedef struct _Server
+{
+  World *world;                      /*!< The world, shared by every game */
+  int epoll;                         /*!< The epoll instance */
+  int listeners[SERVER_LISTENERS];   /*!< Listening sockets */
+  int listener_kinds[SERVER_LISTENERS]; /*!< What the clients of each one are */
+  Server_source listener_sources[SERVER_LISTENERS]; /*!< What the events of each one are for */
+  int n_listeners;                   /*!< Number of listening sockets */
+  int wakeup;                        /*!< Eventfd the workers use to hand sessions back */
+  Server_source wakeup_source;       /*!< What the events of the eventfd are for */
+  pthread_mutex_t returned_lock;     /*!< Guards the sessions handed back */
+  Session *returned;                 /*!< Sessions handed back to the event loop */
+  Executor *executor;                /*!< The workers */
+  Graphic_engine *gengines[EXECUTOR_MAX_WORKERS]; /*!< Graphic engine of every worker */
+  Session *sessions;                 /*!< List of the sessions awake */
+  long n_sessions;                   /*!< Number of sessions, awake or not */
+  long max_sessions;                 /*!< Limit of sessions at once */
+  unsigned long accepted;            /*!< Sessions accepted */
+  long peak;                         /*!< Most sessions at once */
+  Session *hibernated;               /*!< List of the sessions hibernating */
+  Session *finished;                 /*!< Sessions to close once the events taken are handled */
+  Spectator *spectators;             /*!< List of every spectator */
+  Spectator *finished_spectators;    /*!< Spectators to close once the events taken are handled */
+  long n_spectators;                 /*!< Number of spectators */
+  long n_hibernated;                 /*!< Number of sessions hibernating */
+  Slab *session_slab;                /*!< Blocks of the sessions */
+  Slab *play_slab;                   /*!< Blocks of the games of the sessions */
+  Spill *spill;                      /*!< Where the games of the sessions hibernating are */
+  long hibernate_ms;                 /*!< Time without input before hibernating, 0 for never */
+  size_t output_budget;              /*!< Output kept for a client before frames are dropped */
+  Timer_wheel *timers;               /*!< Timers of the sessions, in milliseconds */
+  long kick_ms;                      /*!< Time without input before a session is closed, 0 for never */
+  long turn_ms;                      /*!< Time for a turn, 0 for no limit */
+  unsigned long kicked;              /*!< Sessions closed for being idle */
+  unsigned long timed_turns;         /*!< Turns played by the timers */
+  Server_latency hibernations;       /*!< Sessions put to hibernate */
+  Server_latency restores;           /*!< Sessions woken up */
+  unsigned long commands;            /*!< Commands applied, updated atomically */
+  unsigned long frames;              /*!< Frames sent, updated atomically */
+  unsigned long bytes;               /*!< Bytes written to the sockets, updated atomically */
+  unsigned long broadcasts;          /*!< Frames painted for spectators, updated atomically */
+  unsigned long deliveries;          /*!< Those frames given to a spectator, updated atomically */
+  unsigned long dropped;             /*!< Frames dropped for slow clients, updated atomically */
+  unsigned long spectators_dropped;  /*!< Frames dropped for slow spectators, updated atomically */
+} Server;
+
+volatile sig_atomic_t server_stop = 0;
+volatile sig_atomic_t server_report = 0;
+
+void server_on_signal(int signal);
+STATUS server_listen_tcp(Server *server, int port, int kind);
+STATUS server_listen_unix(Server *server, const char *path, int kind);
+STATUS server_add_listener(Server *server, int fd, int kind);
+void server_run(Server *server);
+void server_accept(Server *server, int listener);
+void server_read(Server *server, Session *session);
+void server_submit(Server *server, Session *session);
+void server_check(Server *server, Session *session);
+void server_close_finished(Server *server);
+void server_take_returned(Server *server);
+void server_work(void *data, void *task, int worker);
+void server_apply(Server *server, Session *session, const char *buf, size_t len);
+void server_play_turns(Server *server, Session *session, unsigned long turns);
+void server_send(Server *server, Session *session, const char *buf, size_t len);
+BOOL server_behind(Server *server, Session *session);
+void server_flush(Server *server, Session *session);
+void server_close(Server *server, Session *session);
+void server_add_spectator(Server *server, int fd);
+void server_read_spectator(Server *server, Spectator *spectator);
+void server_watch(Server *server, Spectator *spectator);
+void server_broadcast(Server *server, Session *session, const char *buf, size_t len, BOOL joining);
+void server_flush_spectator(Server *server, Spectator *spectator);
+void server_drop_frames(Server *server, Spectator *spectator);
+void server_check_spectator(Server *server, Spectator *spectator);
+void server_close_spectator(Server *server, Spectator *spectator);
+void server_release_frame(Server_frame *frame);
+void server_link(Server *server, Session *session);
+void server_unlink(Server *server, Session *session);
+void server_start_timers(Server *server, Session *session);
+void server_on_sleep(void *context, void *data);
+void server_on_kick(void *context, void *data);
+void server_on_turn(void *context, void *data);
+STATUS server_hibernate(Server *server, Session *session);
+STATUS server_restore(Server *server, Session *session);
+void server_print_stats(Server *server);
+STATUS server_set_nonblocking(int fd);
+long server_now_ms();
+double server_ms_since(const struct timespec *start);
+void server_add_latency(Server_latency *latency, double ms);
+
+int main(int argc, char *argv[])
+{
+  Server server;
+  Executor_stats stats;
+  struct sigaction action;
+  struct rlimit limit;
+  struct epoll_event event;
+  char *unix_path = NULL, *delta_unix_path = NULL, *watch_unix_path = NULL, *spill_path = NULL;
+  long n_workers = 0;
+  int port = -1, delta_port = -1, watch_port = -1, i = 0;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "Use: %s <game_data_file> [--port <port>] [--unix <path>] [--delta-port <port>] [--delta-unix <path>]"
+                    " [--watch-port <port>] [--watch-unix <path>]"
+                    " [--max-sessions <n>] [--workers <n>] [--hibernate-ms <ms>] [--spill <path>]"
+                    " [--output-budget <bytes>] [--kick-ms <ms>] [--turn-ms <ms>]\n", argv[0]);
+    return 1;
+  }
+
+  memset(&server, 0, sizeof(server));
+  server.max_sessions = SERVER_MAX_SESSIONS;
+  server.hibernate_ms = SERVER_HIBERNATE_MS;
+  server.output_budget = SERVER_OUTPUT_BUDGET;
+  for (i = 2; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--port") && i + 1 < argc)
+      port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--unix") && i + 1 < argc)
+      unix_path = argv[++i];
+    else if (!strcmp(argv[i], "--delta-port") && i + 1 < argc)
+      delta_port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--delta-unix") && i + 1 < argc)
+      delta_unix_path = argv[++i];
+    else if (!strcmp(argv[i], "--watch-port") && i + 1 < argc)
+      watch_port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--watch-unix") && i + 1 < argc)
+      watch_unix_path = argv[++i];
+    else if (!strcmp(argv[i], "--max-sessions") && i + 1 < argc)
+      server.max_sessions = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--workers") && i + 1 < argc)
+      n_workers = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--hibernate-ms") && i + 1 < argc)
+      server.hibernate_ms = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--spill") && i + 1 < argc)
+      spill_path = argv[++i];
+    else if (!strcmp(argv[i], "--output-budget") && i + 1 < argc)
+      server.output_budget = (size_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--kick-ms") && i + 1 < argc)
+      server.kick_ms = atol(argv[++i]);
+    else if (!strcmp(argv[i], "--turn-ms") && i + 1 < argc)
+      server.turn_ms = atol(argv[++i]);
+    else
+    {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+  if (port < 0 && !unix_path && delta_port < 0 && !delta_unix_path)
+    port = SERVER_PORT;
+  if (n_workers < 1)
+    n_workers = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n_workers < 1)
+    n_workers = 1;
+  if (n_workers > EXECUTOR_MAX_WORKERS)
+    n_workers = EXECUTOR_MAX_WORKERS;
+
+  /* A socket per session, so take every descriptor allowed */
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+  {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = server_on_signal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  sigaction(SIGUSR1, &action, NULL); /* Prints the metrics */
+  action.sa_handler = SIG_IGN; /* A closed client is seen as EPIPE */
+  sigaction(SIGPIPE, &action, NULL);
+
+  if (!(server.world = world_create_from_file(argv[1])))
+  {
+    fprintf(stderr, "Error while loading the world.\n");
+    return 1;
+  }
+  if (!(server.session_slab = slab_create(sizeof(Session), SERVER_SLAB_PAGE)) ||
+      !(server.play_slab = slab_create(sizeof(Session_play), SERVER_SLAB_PAGE)))
+  {
+    fprintf(stderr, "Error while allocating the sessions.\n");
+    return 1;
+  }
+  if (server.hibernate_ms > 0 && !(server.spill = spill_create(spill_path, RECORD_MAX)))
+  {
+    fprintf(stderr, "Error while creating the spill file: %s.\n", strerror(errno));
+    return 1;
+  }
+  if (!(server.timers = timer_wheel_create((unsigned long)server_now_ms(), &server)))
+  {
+    fprintf(stderr, "Error while creating the timers.\n");
+    return 1;
+  }
+  if ((server.epoll = epoll_create1(0)) == -1 || (server.wakeup = eventfd(0, EFD_NONBLOCK)) == -1)
+  {
+    fprintf(stderr, "Error while creating the epoll instance.\n");
+    return 1;
+  }
+  server.wakeup_source.kind = SERVER_SOURCE_WAKEUP;
+  event.events = EPOLLIN | EPOLLET;
+  event.data.ptr = &server.wakeup_source;
+  epoll_ctl(server.epoll, EPOLL_CTL_ADD, server.wakeup, &event);
+
+  if ((port >= 0 && server_listen_tcp(&server, port, SERVER_TEXT) == ERROR) ||
+      (unix_path && server_listen_unix(&server, unix_path, SERVER_TEXT) == ERROR) ||
+      (delta_port >= 0 && server_listen_tcp(&server, delta_port, SERVER_DELTA) == ERROR) ||
+      (delta_unix_path && server_listen_unix(&server, delta_unix_path, SERVER_DELTA) == ERROR) ||
+      (watch_port >= 0 && server_listen_tcp(&server, watch_port, SERVER_WATCH) == ERROR) ||
+      (watch_unix_path && server_listen_unix(&server, watch_unix_path, SERVER_WATCH) == ERROR))
+  {
+    fprintf(stderr, "Error while listening: %s.\n", strerror(errno));
+    return 1;
+  }
+  for (i = 0; i < n_workers; i++)
+  {
+    if (!(server.gengines[i] = graphic_engine_create()))
+    {
+      fprintf(stderr, "Error while initializing graphic engine.\n");
+      return 1;
+    }
+  }
+  pthread_mutex_init(&server.returned_lock, NULL);
+  if (!(server.executor = executor_create((int)n_workers, server_work, &server)))
+  {
+    fprintf(stderr, "Error while starting the workers.\n");
+    return 1;
+  }
+
+  if (port >= 0)
+    fprintf(stderr, "Listening on 127.0.0.1:%d with %ld workers\n", port, n_workers);
+  if (unix_path)
+    fprintf(stderr, "Listening on %s with %ld workers\n", unix_path, n_workers);
+  if (delta_port >= 0)
+    fprintf(stderr, "Listening on 127.0.0.1:%d for the binary protocol\n", delta_port);
+  if (delta_unix_path)
+    fprintf(stderr, "Listening on %s for the binary protocol\n", delta_unix_path);
+  if (watch_port >= 0)
+    fprintf(stderr, "Listening on 127.0.0.1:%d for spectators\n", watch_port);
+  if (watch_unix_path)
+    fprintf(stderr, "Listening on %s for spectators\n", watch_unix_path);
+
+  server_run(&server);
+
+  /* The workers finish the sessions they have before anything is freed */
+  for (i = 0; i < n_workers; i++)
+  {
+    executor_get_stats(server.executor, i, &stats);
+    fprintf(stderr, "Worker %d: %lu runs, %lu stolen, %lu sleeps\n", i, stats.runs, stats.steals, stats.sleeps);
+  }
+  executor_destroy(server.executor);
+  server_print_stats(&server);
+  while (server.sessions)
+    server_close(&server, server.sessions);
+  while (server.hibernated)
+    server_close(&server, server.hibernated);
+  server_close_finished(&server);
+  while (server.spectators)
+    server_close_spectator(&server, server.spectators);
+  for (i = 0; i < server.n_listeners; i++)
+    close(server.listeners[i]);
+  if (unix_path)
+    unlink(unix_path);
+  if (delta_unix_path)
+    unlink(delta_unix_path);
+  if (watch_unix_path)
+    unlink(watch_unix_path);
+  for (i = 0; i < n_workers; i++)
+    graphic_engine_destroy(server.gengines[i]);
+  pthread_mutex_destroy(&server.returned_lock);
+  close(server.wakeup);
+  close(server.epoll);
+  timer_wheel_destroy(server.timers);
+  world_release(server.world);
+  spill_destroy(server.spill);
+  slab_destroy(server.play_slab);
+  slab_destroy(server.session_slab);
+
+  return 0;
+}
+
+/**
+* @brief Asks the server to stop or to print its metrics
+*
+* server_on_signal is the handler of SIGINT and SIGTERM, which stop
+* the server, and of SIGUSR1, which prints the metrics
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param signal is the signal
+*/
+void server_on_signal(int signal)
+{
+  if (signal == SIGUSR1)
+    server_report = 1;
+  else
+    server_stop = 1;
+}
+
+/**
+* @brief Listens on TCP
+*
+* server_listen_tcp listens on a port of localhost
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param port is the port
+* @param kind is what its clients are, SERVER_TEXT, SERVER_DELTA or SERVER_WATCH
+* @return the status
+*/
+STATUS server_listen_tcp(Server *server, int port, int kind)
+{
+  struct sockaddr_in addr;
+  int fd = -1, on = 1;
+
+  if ((fd = socket(AF_INET, SOCK_STREAM, 0)) == -1)
+    return ERROR;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((unsigned short)port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 || listen(fd, SOMAXCONN) == -1)
+  {
+    close(fd);
+    return ERROR;
+  }
+
+  return server_add_listener(server, fd, kind);
+}
+
+/**
+* @brief Listens on a Unix socket
+*
+* server_listen_unix listens on a path, replacing the socket left
+* there by an earlier server
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param path is the path
+* @param kind is what its clients are, SERVER_TEXT, SERVER_DELTA or SERVER_WATCH
+* @return the status
+*/
+STATUS server_listen_unix(Server *server, const char *path, int kind)
+{
+  struct sockaddr_un addr;
+  int fd = -1;
+
+  if (strlen(path) >= sizeof(addr.sun_path))
+  {
+    errno = ENAMETOOLONG;
+    return ERROR;
+  }
+  if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+    return ERROR;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  unlink(path);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 || listen(fd, SOMAXCONN) == -1)
+  {
+    close(fd);
+    return ERROR;
+  }
+
+  return server_add_listener(server, fd, kind);
+}
+
+/**
+* @brief Adds a listening socket to the epoll
+*
+* server_add_listener makes the socket non blocking and waits for
+* connections on it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param fd is the listening socket
+* @param kind is what its clients are, SERVER_TEXT, SERVER_DELTA or SERVER_WATCH
+* @return the status
+*/
+STATUS server_add_listener(Server *server, int fd, int kind)
+{
+  struct epoll_event event;
+  Server_source *source = NULL;
+
+  if (server->n_listeners == SERVER_LISTENERS)
+  {
+    close(fd);
+    return ERROR;
+  }
+  source = &server->listener_sources[server->n_listeners];
+  source->kind = SERVER_SOURCE_LISTENER;
+  source->listener = server->n_listeners;
+
+  event.events = EPOLLIN | EPOLLET;
+  event.data.ptr = source;
+  if (server_set_nonblocking(fd) == ERROR || epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+  {
+    close(fd);
+    return ERROR;
+  }
+
+  server->listener_kinds[server->n_listeners] = kind;
+  server->listeners[server->n_listeners++] = fd;
+  return OK;
+}
+
+/**
+* @brief Runs the event loop
+*
+* server_run waits for the sockets until the server is stopped. As
+* the events are edge triggered, every socket is read or written
+* until it would block. Every tick, the idle sessions hibernate. The
+* sessions and the spectators that finish are only closed once all
+* the events taken have been handled, as a later one may be for them
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+*/
+void server_run(Server *server)
+{
+  struct epoll_event events[SERVER_EVENTS];
+  Server_source *source = NULL;
+  Session *session = NULL;
+  Spectator *spectator = NULL;
+  long wait = 0;
+  int n = 0, i = 0;
+
+  while (!server_stop)
+  {
+    if (server_report)
+    {
+      server_report = 0;
+      server_print_stats(server);
+    }
+    timer_wheel_advance(server->timers, (unsigned long)server_now_ms());
+    server_close_finished(server);
+
+    if ((wait = timer_wheel_next(server->timers)) > SERVER_WAIT_MAX_MS)
+      wait = SERVER_WAIT_MAX_MS;
+    if ((n = epoll_wait(server->epoll, events, SERVER_EVENTS, (int)wait)) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      fprintf(stderr, "Error while waiting for events: %s.\n", strerror(errno));
+      return;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+      source = (Server_source *)events[i].data.ptr;
+      if (source->kind == SERVER_SOURCE_WAKEUP)
+      {
+        server_take_returned(server);
+        continue;
+      }
+      if (source->kind == SERVER_SOURCE_LISTENER)
+      {
+        server_accept(server, source->listener);
+        continue;
+      }
+
+      if (source->kind == SERVER_SOURCE_SPECTATOR)
+      {
+        spectator = (Spectator *)source->owner;
+        if (spectator->closing_later)
+          continue;
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+          server_read_spectator(server, spectator);
+        if (events[i].events & EPOLLOUT)
+        {
+          pthread_mutex_lock(&spectator->lock);
+          server_flush_spectator(server, spectator);
+          pthread_mutex_unlock(&spectator->lock);
+        }
+        server_check_spectator(server, spectator);
+        continue;
+      }
+
+      session = (Session *)source->owner;
+      if (session->closing_later)
+        continue;
+      if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+        server_read(server, session);
+      if (events[i].events & EPOLLOUT)
+      {
+        pthread_mutex_lock(&session->lock);
+        server_flush(server, session);
+        pthread_mutex_unlock(&session->lock);
+      }
+      server_check(server, session);
+    }
+    server_close_finished(server);
+  }
+}
+
+/**
+* @brief Accepts the new connections
+*
+* server_accept creates a session for every connection waiting,
+* and gives it to the workers to send its first frame, or a spectator
+* for the connections to a watch listener
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param listener is the number of the listening socket
+*/
+void server_accept(Server *server, int listener)
+{
+  struct epoll_event event;
+  Session *session = NULL;
+  int fd = -1;
+
+  while ((fd = accept(server->listeners[listener], NULL, NULL)) != -1 || errno == EINTR || errno == ECONNABORTED)
+  {
+    if (fd == -1)
+      continue;
+    if (server->listener_kinds[listener] == SERVER_WATCH)
+    {
+      server_add_spectator(server, fd);
+      continue;
+    }
+
+    if (server->n_sessions >= server->max_sessions || server_set_nonblocking(fd) == ERROR ||
+        !(session = (Session *)slab_alloc(server->session_slab)))
+    {
+      close(fd);
+      continue;
+    }
+    if (!(session->play = (Session_play *)slab_alloc(server->play_slab)) ||
+        game_create_from_world(&session->play->game, server->world) == ERROR)
+    {
+      if (session->play)
+        game_destroy(&session->play->game);
+      slab_free(server->play_slab, session->play);
+      slab_free(server->session_slab, session);
+      close(fd);
+      continue;
+    }
+    session->fd = fd;
+    session->delta = server->listener_kinds[listener] == SERVER_DELTA;
+    pthread_mutex_init(&session->lock, NULL);
+    graphic_feedback_init(&session->play->feedback);
+    session->scheduled = TRUE; /* For the first frame */
+    timer_init(&session->sleep, server_on_sleep, session);
+    timer_init(&session->kick, server_on_kick, session);
+    timer_init(&session->turn, server_on_turn, session);
+
+    session->source.kind = SERVER_SOURCE_SESSION;
+    session->source.owner = session;
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = &session->source;
+    if (epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+    {
+      pthread_mutex_destroy(&session->lock);
+      game_destroy(&session->play->game);
+      slab_free(server->play_slab, session->play);
+      slab_free(server->session_slab, session);
+      close(fd);
+      continue;
+    }
+
+    server_link(server, session);
+    server_start_timers(server, session);
+    session->number = ++server->accepted;
+    if (++server->n_sessions > server->peak)
+      server->peak = server->n_sessions;
+
+    if (executor_submit(server->executor, session) == ERROR)
+    {
+      session->scheduled = FALSE;
+      session->dead = TRUE;
+      server_check(server, session);
+    }
+  }
+}
+
+/**
+* @brief Reads the input of a session
+*
+* server_read reads the socket until it would block, adds what it
+* reads to the input of the session, and gives the session to the
+* workers unless one already has it. A session hibernating is woken
+* up first. The timers of the session start again if anything came
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_read(Server *server, Session *session)
+{
+  char buf[SERVER_READ_SIZE];
+  char *input = NULL;
+  ssize_t n = 0;
+  BOOL submit = FALSE, got = FALSE;
+
+  pthread_mutex_lock(&session->lock);
+  while (!session->dead && !session->closing)
+  {
+    /* The socket is non blocking, so the lock is not held for long */
+    if ((n = read(session->fd, buf, sizeof(buf))) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        session->dead = TRUE;
+      break;
+    }
+    if (n == 0)
+    {
+      session->closing = TRUE; /* The client has finished, what it sent is still applied */
+      break;
+    }
+
+    /* A client whose commands pile up is not kept forever */
+    if (session->input_len + n > SERVER_INPUT_MAX ||
+        !(input = (char *)realloc(session->input, session->input_len + n)))
+    {
+      session->dead = TRUE;
+      break;
+    }
+    memcpy(input + session->input_len, buf, n);
+    session->input = input;
+    session->input_len += n;
+    got = TRUE;
+  }
+
+  if (session->input && !session->scheduled && !session->dead)
+    submit = session->scheduled = TRUE;
+  pthread_mutex_unlock(&session->lock);
+
+  if (got)
+    server_start_timers(server, session);
+  if (submit)
+    server_submit(server, session);
+}
+
+/**
+* @brief Gives a session to the workers
+*
+* server_submit wakes the session up if it hibernates. It is called
+* by the event loop once the session has been marked as scheduled
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_submit(Server *server, Session *session)
+{
+  /* No worker has it, so its game is only touched here */
+  if (!session->play && server_restore(server, session) == ERROR)
+  {
+    pthread_mutex_lock(&session->lock);
+    session->scheduled = FALSE;
+    session->dead = TRUE;
+    pthread_mutex_unlock(&session->lock);
+    return;
+  }
+
+  if (executor_submit(server->executor, session) == ERROR)
+  {
+    pthread_mutex_lock(&session->lock);
+    session->scheduled = FALSE;
+    session->dead = TRUE;
+    pthread_mutex_unlock(&session->lock);
+  }
+}
+
+/**
+* @brief Checks whether a session has finished
+*
+* server_check leaves the session to be closed when no worker has it
+* and it is dead, or it is closing and everything has been written.
+* It is not closed yet, as the events being handled may refer to it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_check(Server *server, Session *session)
+{
+  BOOL finished = FALSE;
+
+  if (session->closing_later)
+    return;
+
+  pthread_mutex_lock(&session->lock);
+  finished = !session->scheduled && !session->returning &&
+             (session->dead || (session->closing && !session->out && !session->input));
+  pthread_mutex_unlock(&session->lock);
+
+  if (finished)
+  {
+    session->closing_later = TRUE;
+    session->finished = server->finished;
+    server->finished = session;
+  }
+}
+
+/**
+* @brief Closes the sessions and the spectators that have finished
+*
+* server_close_finished closes the sessions server_check left to be
+* closed, once no event being handled refers to them, and then the
+* spectators, including the ones of those sessions
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+*/
+void server_close_finished(Server *server)
+{
+  Session *session = NULL;
+  Spectator *spectator = NULL;
+
+  while ((session = server->finished))
+  {
+    server->finished = session->finished;
+    server_close(server, session);
+  }
+  while ((spectator = server->finished_spectators))
+  {
+    server->finished_spectators = spectator->finished;
+    server_close_spectator(server, spectator);
+  }
+}
+
+/**
+* @brief Takes the sessions handed back by the workers
+*
+* server_take_returned checks every session a worker has finished
+* with while it was dead or closing
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+*/
+void server_take_returned(Server *server)
+{
+  Session *session = NULL, *next = NULL;
+  unsigned long count = 0;
+
+  while (read(server->wakeup, &count, sizeof(count)) == -1 && errno == EINTR)
+    ;
+
+  pthread_mutex_lock(&server->returned_lock);
+  session = server->returned;
+  server->returned = NULL;
+  pthread_mutex_unlock(&server->returned_lock);
+
+  for (; session; session = next)
+  {
+    next = session->returned;
+    pthread_mutex_lock(&session->lock);
+    session->returning = FALSE;
+    pthread_mutex_unlock(&session->lock);
+    server_check(server, session);
+  }
+}
+
+/**
+* @brief Runs a session in a worker
+*
+* server_work applies all the input of the session in a row and
+* paints a single frame for it, or encodes what changed for a client
+* of the binary protocol, again while more input comes. The frame
+* is painted once more for the spectators only if the client speaks
+* the binary protocol. Then the session is left, and handed back to
+* the event loop if it is dead or closing
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param data is the server
+* @param task is the session
+* @param worker is the number of the worker
+*/
+void server_work(void *data, void *task, int worker)
+{
+  Server *server = (Server *)data;
+  Session *session = (Session *)task;
+  Session_play *play = session->play;
+  Game_state state, before;
+  unsigned char message[DELTA_MESSAGE_MAX];
+  const char *frame = NULL, *painted = NULL;
+  char *input = NULL;
+  size_t input_len = 0, len = 0, painted_len = 0;
+  unsigned long count = 1, turns = 0;
+  BOOL back = FALSE, repaint = FALSE, watched = FALSE, changed = FALSE, hello = FALSE;
+
+  pthread_mutex_lock(&session->lock);
+  while (TRUE)
+  {
+    input = session->input;
+    input_len = session->input_len;
+    session->input = NULL;
+    session->input_len = 0;
+    turns = session->timed_turns;
+    session->timed_turns = 0;
+    repaint = session->repaint;
+    session->repaint = FALSE;
+    watched = session->spectators != NULL;
+    pthread_mutex_unlock(&session->lock);
+
+    /* The game is only used by this worker, so nothing is locked */
+    frame = painted = NULL;
+    hello = !play->painted;
+    game_get_state(&play->game, &before);
+    if (turns && !play->exited)
+      server_play_turns(server, session, turns);
+    if (input && !play->exited)
+      server_apply(server, session, input, input_len);
+    free(input);
+    changed = !play->painted || ((input || turns) && !play->exited);
+    if (changed || repaint)
+    {
+      game_get_state(&play->game, &state);
+      if (changed)
+        graphic_feedback_add(&play->feedback, &state);
+      if (!session->delta || watched)
+        painted = graphic_engine_render_frame(server->gengines[worker], &play->game, &state,
+                                              &play->feedback, &painted_len);
+      /* A repaint is only for the spectators, the client has the frame */
+      if (changed && !session->delta)
+      {
+        frame = painted;
+        len = painted_len;
+      }
+      play->painted = TRUE;
+    }
+
+    pthread_mutex_lock(&session->lock);
+    if (play->exited)
+      session->closing = TRUE;
+    if (changed && session->delta && !session->dead)
+    {
+      /* The client paints the frame from what changed since the last
+         message it keeps, as the ones waiting are dropped if it is behind */
+      if (!session->waiting)
+        play->waiting_from = before;
+      len = hello ? delta_encode_hello(game_world_fingerprint(&play->game), &state, message)
+                  : delta_encode(server_behind(server, session) ? &play->waiting_from : &before, &state, message);
+      frame = (const char *)message;
+    }
+    if (frame && !session->dead)
+    {
+      server_send(server, session, frame, len);
+      __atomic_add_fetch(&server->frames, 1, __ATOMIC_RELAXED);
+    }
+    if (painted && session->spectators)
+      server_broadcast(server, session, painted, painted_len, !changed);
+    if ((!session->input && !session->repaint && !session->timed_turns) || play->exited || session->dead)
+      break;
+  }
+
+  free(session->input); /* Left after the exit command */
+  session->input = NULL;
+  session->input_len = 0;
+  session->scheduled = FALSE;
+  back = session->returning = session->dead || session->closing;
+  pthread_mutex_unlock(&session->lock);
+
+  if (back)
+  {
+    pthread_mutex_lock(&server->returned_lock);
+    session->returned = server->returned;
+    server->returned = session;
+    pthread_mutex_unlock(&server->returned_lock);
+    while (write(server->wakeup, &count, sizeof(count)) == -1 && errno == EINTR)
+      ;
+  }
+}
+
+/**
+* @brief Applies the input of a session
+*
+* server_apply parses the command lines of the input and applies
+* them to the game of the session, until the exit command
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+* @param buf is the input
+* @param len is the number of bytes of the input
+*/
+void server_apply(Server *server, Session *session, const char *buf, size_t len)
+{
+  Session_play *play = session->play;
+  Command command;
+  size_t i = 0;
+
+  for (i = 0; i < len && !play->exited; i++)
+  {
+    if (buf[i] != '\n')
+    {
+      if (play->line_len < SERVER_LINE_MAX)
+        play->line[play->line_len++] = buf[i];
+      else
+        play->discarding = TRUE;
+      continue;
+    }
+
+    if (!play->discarding && command_parse(play->line, play->line_len, &command) == OK)
+    {
+      game_update_command(&play->game, &command);
+      __atomic_add_fetch(&server->commands, 1, __ATOMIC_RELAXED);
+      if (command.cmd == EXIT || game_is_over(&play->game))
+        play->exited = TRUE;
+    }
+    play->line_len = 0;
+    play->discarding = FALSE;
+  }
+}
+
+/**
+* @brief Plays the turns of a client that took too long
+*
+* server_play_turns moves the player of the session to the next space
+* once for every turn, until the game finishes
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+* @param turns is the number of turns
+*/
+void server_play_turns(Server *server, Session *session, unsigned long turns)
+{
+  Session_play *play = session->play;
+  Command command;
+
+  command.cmd = NEXT;
+  command.arg[0] = '\0';
+  for (; turns > 0 && !play->exited; turns--)
+  {
+    game_update_command(&play->game, &command);
+    __atomic_add_fetch(&server->commands, 1, __ATOMIC_RELAXED);
+    if (game_is_over(&play->game))
+      play->exited = TRUE;
+  }
+}
+
+/**
+* @brief Sends bytes to a session
+*
+* server_send writes a frame at once if nothing is waiting before
+* it, and keeps what the socket does not take. When the client is
+* behind, the frames waiting that it has not started to get are
+* dropped for this one. It is called with the lock of the session held
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+* @param buf is the frame
+* @param len is the number of bytes of the frame
+*/
+void server_send(Server *server, Session *session, const char *buf, size_t len)
+{
+  ssize_t n = 0;
+  char *waiting = NULL;
+
+  /* Straight to the socket when there is nothing waiting */
+  while (!session->out && len > 0)
+  {
+    if ((n = write(session->fd, buf, len)) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      session->dead = TRUE;
+      return;
+    }
+    __atomic_add_fetch(&server->bytes, n, __ATOMIC_RELAXED);
+    buf += n;
+    len -= n;
+  }
+  if (len == 0)
+    return;
+
+  /* The rest of a frame started is always written */
+  if (!session->out)
+  {
+    if (!(session->out = (char *)malloc(len)))
+    {
+      session->dead = TRUE;
+      return;
+    }
+    memcpy(session->out, buf, len);
+    session->out_len = len;
+    session->out_sent = 0;
+    return;
+  }
+
+  if (server_behind(server, session))
+  {
+    session->dropped += session->waiting_frames;
+    __atomic_add_fetch(&server->dropped, session->waiting_frames, __ATOMIC_RELAXED);
+    free(session->waiting);
+    session->waiting = NULL;
+    session->waiting_len = 0;
+    session->waiting_frames = 0;
+  }
+  if (!(waiting = (char *)realloc(session->waiting, session->waiting_len + len)))
+  {
+    session->dead = TRUE;
+    return;
+  }
+  memcpy(waiting + session->waiting_len, buf, len);
+  session->waiting = waiting;
+  session->waiting_len += len;
+  session->waiting_frames++;
+}
+
+/**
+* @brief Tells whether a client is behind
+*
+* server_behind tells whether the output kept for the client is over
+* the budget, so the next frame replaces the ones waiting. It does not
+* depend on the frame, so a message of the binary protocol can be
+* encoded from the right state before it is sent. It is called with
+* the lock of the session held
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+* @return TRUE if the frames waiting are to be dropped
+*/
+BOOL server_behind(Server *server, Session *session)
+{
+  return session->waiting && session->out_len - session->out_sent + session->waiting_len >= server->output_budget;
+}
+
+/**
+* @brief Writes the output kept of a session
+*
+* server_flush writes until the socket would block, the frame being
+* written and then the frames waiting, and frees the output once it
+* has all been written. It is called with the lock of the session held
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_flush(Server *server, Session *session)
+{
+  ssize_t n = 0;
+
+  while (session->out)
+  {
+    while (session->out_sent < session->out_len)
+    {
+      if ((n = write(session->fd, session->out + session->out_sent, session->out_len - session->out_sent)) == -1)
+      {
+        if (errno == EINTR)
+          continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+          session->dead = TRUE;
+        return;
+      }
+      __atomic_add_fetch(&server->bytes, n, __ATOMIC_RELAXED);
+      session->out_sent += n;
+    }
+
+    free(session->out);
+    session->out = session->waiting;
+    session->out_len = session->waiting_len;
+    session->out_sent = 0;
+    session->waiting = NULL;
+    session->waiting_len = 0;
+    session->waiting_frames = 0;
+  }
+}
+
+/**
+* @brief Closes a session
+*
+* server_close closes the socket and frees the session. Its
+* spectators are closed once they have been sent the frames they
+* have waiting. It is only called by the event loop, when no worker
+* has the session
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_close(Server *server, Session *session)
+{
+  Spectator *spectator = NULL, *next = NULL;
+
+  for (spectator = session->spectators; spectator; spectator = next)
+  {
+    next = spectator->next;
+    spectator->prev = spectator->next = NULL;
+    spectator->watched = NULL;
+    pthread_mutex_lock(&spectator->lock);
+    spectator->closing = TRUE;
+    pthread_mutex_unlock(&spectator->lock);
+    server_check_spectator(server, spectator);
+  }
+  session->spectators = NULL;
+
+  timer_wheel_cancel(server->timers, &session->sleep);
+  timer_wheel_cancel(server->timers, &session->kick);
+  timer_wheel_cancel(server->timers, &session->turn);
+  server_unlink(server, session);
+  server->n_sessions--;
+
+  close(session->fd); /* It also leaves the epoll */
+  pthread_mutex_destroy(&session->lock);
+  if (session->play)
+  {
+    game_destroy(&session->play->game);
+    slab_free(server->play_slab, session->play);
+  }
+  else
+  {
+    spill_drop(server->spill, session->slot);
+  }
+  free(session->input);
+  free(session->out);
+  free(session->waiting);
+  slab_free(server->session_slab, session);
+}
+
+/**
+* @brief Adds a spectator
+*
+* server_add_spectator waits for the number of the session the new
+* connection watches
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param fd is the socket of the spectator
+*/
+void server_add_spectator(Server *server, int fd)
+{
+  struct epoll_event event;
+  Spectator *spectator = NULL;
+
+  if (server_set_nonblocking(fd) == ERROR || !(spectator = (Spectator *)calloc(1, sizeof(Spectator))))
+  {
+    close(fd);
+    return;
+  }
+  spectator->source.kind = SERVER_SOURCE_SPECTATOR;
+  spectator->source.owner = spectator;
+  spectator->fd = fd;
+
+  event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+  event.data.ptr = &spectator->source;
+  if (epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+  {
+    free(spectator);
+    close(fd);
+    return;
+  }
+  pthread_mutex_init(&spectator->lock, NULL);
+
+  spectator->all_next = server->spectators;
+  if (server->spectators)
+    server->spectators->all_prev = spectator;
+  server->spectators = spectator;
+  server->n_spectators++;
+}
+
+/**
+* @brief Reads the input of a spectator
+*
+* server_read_spectator reads the socket until it would block. Until
+* the spectator watches a session, what it reads is the number of the
+* session, and anything else is ignored
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param spectator is the spectator
+*/
+void server_read_spectator(Server *server, Spectator *spectator)
+{
+  char buf[SERVER_READ_SIZE];
+  ssize_t n = 0, i = 0;
+  BOOL dead = FALSE;
+
+  while (!dead)
+  {
+    if ((n = read(spectator->fd, buf, sizeof(buf))) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      dead = errno != EAGAIN && errno != EWOULDBLOCK;
+      break;
+    }
+    if (n == 0)
+    {
+      dead = TRUE; /* A spectator that has gone has nothing else to get */
+      break;
+    }
+
+    for (i = 0; i < n && !spectator->watched; i++)
+    {
+      if (buf[i] == '\n')
+      {
+        server_watch(server, spectator);
+        break;
+      }
+      if (spectator->line_len == SERVER_LINE_MAX - 1)
+      {
+        dead = TRUE;
+        break;
+      }
+      spectator->line[spectator->line_len++] = buf[i];
+    }
+  }
+
+  if (dead)
+  {
+    pthread_mutex_lock(&spectator->lock);
+    spectator->dead = TRUE;
+    pthread_mutex_unlock(&spectator->lock);
+  }
+}
+
+/**
+* @brief Makes a spectator watch the session it asked for
+*
+* server_watch links the spectator to the session, and gives the
+* session to the workers to paint a frame for it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param spectator is the spectator, with the number of the session received
+*/
+void server_watch(Server *server, Spectator *spectator)
+{
+  const char *missing = "There is no such game.\n";
+  Session *session = NULL;
+  unsigned long number = 0;
+  BOOL submit = FALSE, found = FALSE;
+  int list = 0;
+
+  spectator->line[spectator->line_len] = '\0';
+  number = strtoul(spectator->line, NULL, 10);
+  for (list = 0; list < 2 && !session; list++)
+    for (session = list ? server->hibernated : server->sessions; session && session->number != number;
+         session = session->next)
+      ;
+
+  if (session)
+  {
+    pthread_mutex_lock(&session->lock);
+    found = !session->dead && !session->closing;
+    if (found)
+    {
+      spectator->watched = session;
+      spectator->number = number;
+      spectator->joining = TRUE;
+      spectator->prev = NULL;
+      spectator->next = session->spectators;
+      if (session->spectators)
+        session->spectators->prev = spectator;
+      session->spectators = spectator;
+      session->repaint = TRUE;
+      if (!session->scheduled)
+        submit = session->scheduled = TRUE;
+    }
+    pthread_mutex_unlock(&session->lock);
+  }
+
+  if (!found)
+  {
+    /* Best effort, the spectator is closed anyway */
+    while (write(spectator->fd, missing, strlen(missing)) == -1 && errno == EINTR)
+      ;
+    pthread_mutex_lock(&spectator->lock);
+    spectator->dead = TRUE;
+    pthread_mutex_unlock(&spectator->lock);
+    return;
+  }
+  if (submit)
+    server_submit(server, session);
+}
+
+/**
+* @brief Gives a frame to the spectators of a session
+*
+* server_broadcast copies the frame once in a buffer counted by
+* reference, which every spectator keeps until it has written it.
+* A spectator that is behind gets it instead of the frames it has
+* waiting. It is called with the lock of the session held
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session watched
+* @param buf is the painted frame
+* @param len is the number of bytes of the frame
+* @param joining is whether the frame is only for the spectators that
+* have just joined, as nothing has changed for the rest
+*/
+void server_broadcast(Server *server, Session *session, const char *buf, size_t len, BOOL joining)
+{
+  Server_frame *frame = NULL;
+  Spectator *spectator = NULL;
+  unsigned long given = 0;
+
+  if (!(frame = (Server_frame *)malloc(sizeof(Server_frame) + len)))
+    return;
+  frame->refs = 1; /* Until it has been given to all of them */
+  frame->len = len;
+  frame->data = (char *)(frame + 1);
+  memcpy(frame->data, buf, len);
+
+  for (spectator = session->spectators; spectator; spectator = spectator->next)
+  {
+    if (joining && !spectator->joining)
+      continue;
+    spectator->joining = FALSE;
+
+    pthread_mutex_lock(&spectator->lock);
+    if (!spectator->dead &&
+        (spectator->n_frames == SERVER_SPECTATOR_FRAMES || spectator->queued >= server->output_budget))
+      server_drop_frames(server, spectator);
+    if (!spectator->dead)
+    {
+      __atomic_add_fetch(&frame->refs, 1, __ATOMIC_RELAXED);
+      spectator->frames[(spectator->first + spectator->n_frames++) % SERVER_SPECTATOR_FRAMES] = frame;
+      spectator->queued += len;
+      server_flush_spectator(server, spectator);
+      given++;
+    }
+    pthread_mutex_unlock(&spectator->lock);
+  }
+
+  server_release_frame(frame);
+  __atomic_add_fetch(&server->broadcasts, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&server->deliveries, given, __ATOMIC_RELAXED);
+}
+
+/**
+* @brief Writes the frames a spectator has waiting
+*
+* server_flush_spectator writes all of them with a single writev,
+* again until the socket would block, and releases the frames
+* written. It is called with the lock of the spectator held
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param spectator is the spectator
+*/
+void server_flush_spectator(Server *server, Spectator *spectator)
+{
+  struct iovec iov[SERVER_SPECTATOR_FRAMES];
+  Server_frame *frame = NULL;
+  ssize_t n = 0;
+  size_t done = 0;
+  int i = 0;
+
+  while (spectator->n_frames > 0 && !spectator->dead)
+  {
+    for (i = 0; i < spectator->n_frames; i++)
+    {
+      frame = spectator->frames[(spectator->first + i) % SERVER_SPECTATOR_FRAMES];
+      iov[i].iov_base = frame->data + (i ? 0 : spectator->sent);
+      iov[i].iov_len = frame->len - (i ? 0 : spectator->sent);
+    }
+    if ((n = writev(spectator->fd, iov, spectator->n_frames)) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        spectator->dead = TRUE;
+      return;
+    }
+    __atomic_add_fetch(&server->bytes, n, __ATOMIC_RELAXED);
+
+    for (done = spectator->sent + n; spectator->n_frames > 0; spectator->n_frames--)
+    {
+      frame = spectator->frames[spectator->first];
+      if (done < frame->len)
+        break;
+      done -= frame->len;
+      spectator->queued -= frame->len;
+      server_release_frame(frame);
+      spectator->first = (spectator->first + 1) % SERVER_SPECTATOR_FRAMES;
+    }
+    spectator->sent = done;
+  }
+}
+
+/**
+* @brief Drops the frames a spectator has waiting
+*
+* server_drop_frames releases the frames waiting, but the one being
+* written. It is called with the lock of the spectator held
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param spectator is the spectator
+*/
+void server_drop_frames(Server *server, Spectator *spectator)
+{
+  Server_frame *frame = NULL;
+  int keep = spectator->sent > 0 ? 1 : 0;
+
+  while (spectator->n_frames > keep)
+  {
+    frame = spectator->frames[(spectator->first + --spectator->n_frames) % SERVER_SPECTATOR_FRAMES];
+    spectator->queued -= frame->len;
+    server_release_frame(frame);
+    spectator->dropped++;
+    __atomic_add_fetch(&server->spectators_dropped, 1, __ATOMIC_RELAXED);
+  }
+}
+
+/**
+* @brief Checks whether a spectator has finished
+*
+* server_check_spectator leaves the spectator to be closed when it is
+* dead, or it is closing and all its frames have been written. As for
+* a session, it is not closed while the events are being handled
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param spectator is the spectator
+*/
+void server_check_spectator(Server *server, Spectator *spectator)
+{
+  BOOL finished = FALSE;
+
+  if (spectator->closing_later)
+    return;
+
+  pthread_mutex_lock(&spectator->lock);
+  finished = spectator->dead || (spectator->closing && spectator->n_frames == 0);
+  pthread_mutex_unlock(&spectator->lock);
+
+  if (finished)
+  {
+    spectator->closing_later = TRUE;
+    spectator->finished = server->finished_spectators;
+    server->finished_spectators = spectator;
+  }
+}
+
+/**
+* @brief Closes a spectator
+*
+* server_close_spectator takes the spectator out of the session it
+* watches, so no worker gives it frames any more, and frees it. It is
+* only called by the event loop
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param spectator is the spectator
+*/
+void server_close_spectator(Server *server, Spectator *spectator)
+{
+  Session *session = spectator->watched;
+
+  if (session)
+  {
+    pthread_mutex_lock(&session->lock);
+    if (spectator->prev)
+      spectator->prev->next = spectator->next;
+    else
+      session->spectators = spectator->next;
+    if (spectator->next)
+      spectator->next->prev = spectator->prev;
+    pthread_mutex_unlock(&session->lock);
+  }
+
+  if (spectator->all_prev)
+    spectator->all_prev->all_next = spectator->all_next;
+  else
+    server->spectators = spectator->all_next;
+  if (spectator->all_next)
+    spectator->all_next->all_prev = spectator->all_prev;
+  server->n_spectators--;
+
+  close(spectator->fd);
+  for (; spectator->n_frames > 0; spectator->n_frames--)
+  {
+    server_release_frame(spectator->frames[spectator->first]);
+    spectator->first = (spectator->first + 1) % SERVER_SPECTATOR_FRAMES;
+  }
+  pthread_mutex_destroy(&spectator->lock);
+  free(spectator);
+}
+
+/**
+* @brief Releases a reference to a frame
+*
+* server_release_frame frees the frame with its last reference
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param frame is the frame
+*/
+void server_release_frame(Server_frame *frame)
+{
+  if (__atomic_sub_fetch(&frame->refs, 1, __ATOMIC_ACQ_REL) == 0)
+    free(frame);
+}
+
+/**
+* @brief Adds a session to its list
+*
+* server_link puts a session awake in the list of the sessions awake,
+* and a session hibernating in the list of the sessions hibernating
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_link(Server *server, Session *session)
+{
+  Session **first = session->play ? &server->sessions : &server->hibernated;
+
+  session->prev = NULL;
+  session->next = *first;
+  if (*first)
+    (*first)->prev = session;
+  *first = session;
+  if (!session->play)
+    server->n_hibernated++;
+}
+
+/**
+* @brief Takes a session out of its list
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_unlink(Server *server, Session *session)
+{
+  if (session->prev)
+    session->prev->next = session->next;
+  else if (session->play)
+    server->sessions = session->next;
+  else
+    server->hibernated = session->next;
+
+  if (session->next)
+    session->next->prev = session->prev;
+
+  if (!session->play)
+    server->n_hibernated--;
+  session->prev = session->next = NULL;
+}
+
+/**
+* @brief Starts the timers of a session
+*
+* server_start_timers schedules the timers of the session again, as
+* the client has just sent something. The wheel is only advanced by
+* server_run, as its timers may close sessions, so the time since then
+* is added to every delay
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+*/
+void server_start_timers(Server *server, Session *session)
+{
+  unsigned long now = (unsigned long)server_now_ms(), late = 0;
+
+  if (now > timer_wheel_get_now(server->timers))
+    late = now - timer_wheel_get_now(server->timers);
+  if (server->spill)
+    timer_wheel_schedule(server->timers, &session->sleep, late + (unsigned long)server->hibernate_ms);
+  if (server->kick_ms > 0)
+    timer_wheel_schedule(server->timers, &session->kick, late + (unsigned long)server->kick_ms);
+  if (server->turn_ms > 0)
+    timer_wheel_schedule(server->timers, &session->turn, late + (unsigned long)server->turn_ms);
+}
+
+/**
+* @brief Puts an idle session to hibernate
+*
+* server_on_sleep is called when the client of the session has not
+* sent anything for a while. A session that can not hibernate yet,
+* because it is busy or has output waiting, is tried again after a
+* while
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the server
+* @param data is the session
+*/
+void server_on_sleep(void *context, void *data)
+{
+  Server *server = (Server *)context;
+  Session *session = (Session *)data;
+
+  if (session->play && server_hibernate(server, session) == ERROR)
+    timer_wheel_schedule(server->timers, &session->sleep, (unsigned long)server->hibernate_ms);
+}
+
+/**
+* @brief Closes a session whose client is away
+*
+* server_on_kick marks the session as dead, so it is closed as soon
+* as no worker has it
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the server
+* @param data is the session
+*/
+void server_on_kick(void *context, void *data)
+{
+  Server *server = (Server *)context;
+  Session *session = (Session *)data;
+
+  timer_wheel_cancel(server->timers, &session->turn);
+  pthread_mutex_lock(&session->lock);
+  session->dead = TRUE;
+  pthread_mutex_unlock(&session->lock);
+  server->kicked++;
+  server_check(server, session);
+}
+
+/**
+* @brief Plays the turn of a client that takes too long
+*
+* server_on_turn gives the session to the workers to play the turn,
+* and gives the client another turn. A session hibernating is woken
+* up first
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param context is the server
+* @param data is the session
+*/
+void server_on_turn(void *context, void *data)
+{
+  Server *server = (Server *)context;
+  Session *session = (Session *)data;
+  BOOL submit = FALSE, over = FALSE;
+
+  pthread_mutex_lock(&session->lock);
+  over = session->dead || session->closing;
+  if (!over)
+  {
+    session->timed_turns++;
+    if (!session->scheduled)
+      submit = session->scheduled = TRUE;
+  }
+  pthread_mutex_unlock(&session->lock);
+  if (over)
+    return;
+
+  server->timed_turns++;
+  timer_wheel_schedule(server->timers, &session->turn, (unsigned long)server->turn_ms);
+  if (submit)
+    server_submit(server, session);
+}
+
+/**
+* @brief Puts a session to hibernate
+*
+* server_hibernate encodes the game of the session, with its feedback
+* and the line being parsed, writes it in the spill file and frees it.
+* Only a session that no worker has, with nothing to read or to write,
+* hibernates
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+* @return ERROR if the session can not hibernate now
+*/
+STATUS server_hibernate(Server *server, Session *session)
+{
+  unsigned char record[RECORD_MAX];
+  Session_play *play = session->play;
+  struct timespec start;
+  size_t len = 0, game_len = 0;
+  BOOL idle = FALSE;
+  int i = 0;
+
+  pthread_mutex_lock(&session->lock);
+  idle = !session->scheduled && !session->returning && !session->dead && !session->closing &&
+         !session->input && !session->out;
+  pthread_mutex_unlock(&session->lock);
+  if (!idle)
+    return ERROR;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  record[RECORD_FLAGS_AT] = (play->painted ? RECORD_PAINTED : 0) | (play->exited ? RECORD_EXITED : 0) |
+                            (play->discarding ? RECORD_DISCARDING : 0);
+  record[RECORD_FEEDBACK_AT] = (unsigned char)play->feedback.count;
+  record[RECORD_LINE_AT] = (unsigned char)play->line_len;
+  len = RECORD_HEADER;
+  for (i = 0; i < play->feedback.count; i++)
+    record[len++] = play->feedback.lines[(play->feedback.head - play->feedback.count + i + GRAPHIC_FEEDBACK_LINES) %
+                                         GRAPHIC_FEEDBACK_LINES];
+  memcpy(record + len, play->line, play->line_len);
+  len += play->line_len;
+
+  if (!(game_len = game_encode(&play->game, record + len, sizeof(record) - len)) ||
+      (session->slot = spill_put(server->spill, record, len + game_len)) == -1)
+  {
+    server->hibernations.failed++;
+    return ERROR;
+  }
+
+  server_unlink(server, session);
+  game_destroy(&play->game);
+  slab_free(server->play_slab, play);
+  session->play = NULL;
+  server_link(server, session);
+
+  server_add_latency(&server->hibernations, server_ms_since(&start));
+  return OK;
+}
+
+/**
+* @brief Wakes up a session hibernating
+*
+* server_restore reads the game of the session back from the spill
+* file and leaves the session in the list of the sessions awake
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+* @param session is the session
+* @return ERROR if the game could not be read back
+*/
+STATUS server_restore(Server *server, Session *session)
+{
+  unsigned char record[RECORD_MAX];
+  Session_play *play = NULL;
+  struct timespec start;
+  long len = 0;
+  size_t at = RECORD_HEADER;
+  int i = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  len = spill_take(server->spill, session->slot, record, sizeof(record));
+  session->slot = -1; /* Taken, even if it could not be read */
+  if (len < RECORD_HEADER || record[RECORD_FEEDBACK_AT] > GRAPHIC_FEEDBACK_LINES ||
+      record[RECORD_LINE_AT] > SERVER_LINE_MAX ||
+      RECORD_HEADER + record[RECORD_FEEDBACK_AT] + record[RECORD_LINE_AT] > len ||
+      !(play = (Session_play *)slab_alloc(server->play_slab)))
+  {
+    server->restores.failed++;
+    return ERROR;
+  }
+
+  /* The slot is free now, so the session is dead if anything fails */
+  server_unlink(server, session);
+  session->play = play;
+  server_link(server, session);
+  if (game_create_from_world(&play->game, server->world) == ERROR)
+  {
+    server->restores.failed++;
+    return ERROR;
+  }
+
+  play->painted = record[RECORD_FLAGS_AT] & RECORD_PAINTED ? TRUE : FALSE;
+  play->exited = record[RECORD_FLAGS_AT] & RECORD_EXITED ? TRUE : FALSE;
+  play->discarding = record[RECORD_FLAGS_AT] & RECORD_DISCARDING ? TRUE : FALSE;
+  play->feedback.count = record[RECORD_FEEDBACK_AT];
+  play->feedback.head = play->feedback.count % GRAPHIC_FEEDBACK_LINES;
+  for (i = 0; i < play->feedback.count; i++)
+    play->feedback.lines[i] = record[at++];
+  play->line_len = record[RECORD_LINE_AT];
+  memcpy(play->line, record + at, play->line_len);
+  at += play->line_len;
+
+  if (game_decode(&play->game, record + at, len - at) == ERROR)
+  {
+    server->restores.failed++;
+    return ERROR;
+  }
+
+  server_add_latency(&server->restores, server_ms_since(&start));
+  return OK;
+}
+
+/**
+* @brief Prints the metrics of the server
+*
+* server_print_stats prints the sessions, the traffic, the frames
+* dropped for every client, the timers, the memory of the slabs and
+* the hibernations to stderr
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param server is the server
+*/
+void server_print_stats(Server *server)
+{
+  Slab_stats sessions, plays;
+  Spill_stats spill;
+  Timer_wheel_stats timers;
+  Session *session = NULL;
+  Spectator *spectator = NULL;
+  unsigned long dropped = 0, hits = 0, misses = 0;
+  int list = 0, i = 0;
+
+  slab_get_stats(server->session_slab, &sessions);
+  slab_get_stats(server->play_slab, &plays);
+  fprintf(stderr, "Sessions: %lu, at most %ld at once, %ld now, %ld hibernating\n", server->accepted,
+          server->peak, server->n_sessions, server->n_hibernated);
+  fprintf(stderr, "Commands: %lu, frames: %lu, bytes sent: %lu\n", server->commands, server->frames, server->bytes);
+  fprintf(stderr, "Spectators: %ld now, %lu frames painted for them, given %lu times\n", server->n_spectators,
+          server->broadcasts, server->deliveries);
+  fprintf(stderr, "Frames dropped: %lu for clients, %lu for spectators\n", server->dropped,
+          server->spectators_dropped);
+  for (i = 0; i < EXECUTOR_MAX_WORKERS && server->gengines[i]; i++)
+  {
+    graphic_engine_get_cache_stats(server->gengines[i], &hits, &misses);
+    fprintf(stderr, "  Worker %d frame cache: %lu hits, %lu misses\n", i, hits, misses);
+  }
+  for (list = 0; list < 2; list++)
+  {
+    for (session = list ? server->hibernated : server->sessions; session; session = session->next)
+    {
+      pthread_mutex_lock(&session->lock);
+      dropped = session->dropped;
+      pthread_mutex_unlock(&session->lock);
+      if (dropped)
+        fprintf(stderr, "  Session %lu: %lu frames dropped\n", session->number, dropped);
+    }
+  }
+  for (spectator = server->spectators; spectator; spectator = spectator->all_next)
+  {
+    pthread_mutex_lock(&spectator->lock);
+    dropped = spectator->dropped;
+    pthread_mutex_unlock(&spectator->lock);
+    if (dropped)
+      fprintf(stderr, "  Spectator of session %lu: %lu frames dropped\n", spectator->number, dropped);
+  }
+  timer_wheel_get_stats(server->timers, &timers);
+  fprintf(stderr, "Timers: %lu pending, %lu fired, %lu cancelled, %lu moved down the wheel\n", timers.pending,
+          timers.fired, timers.cancelled, timers.cascaded);
+  fprintf(stderr, "Kicked: %lu idle sessions, turns played by the timers: %lu\n", server->kicked,
+          server->timed_turns);
+  fprintf(stderr, "Slabs: %lu sessions of %lu bytes in %lu pages, %lu games of %lu bytes in %lu pages\n",
+          sessions.in_use, (unsigned long)sessions.block_size, sessions.pages,
+          plays.in_use, (unsigned long)plays.block_size, plays.pages);
+
+  if (!server->spill)
+    return;
+  spill_get_stats(server->spill, &spill);
+  fprintf(stderr, "Hibernated: %lu, %lu failed, %.3f ms on average, %.3f ms at most\n",
+          server->hibernations.count, server->hibernations.failed,
+          server->hibernations.count ? server->hibernations.total_ms / server->hibernations.count : 0.0,
+          server->hibernations.max_ms);
+  fprintf(stderr, "Restored: %lu, %lu failed, %.3f ms on average, %.3f ms at most\n",
+          server->restores.count, server->restores.failed,
+          server->restores.count ? server->restores.total_ms / server->restores.count : 0.0,
+          server->restores.max_ms);
+  fprintf(stderr, "Spill file: %lu records in %lu slots, %lu bytes written, %lu read\n",
+          spill.records, spill.slots, spill.written, spill.read);
+}
+
+/**
+* @brief Makes a socket non blocking
+*
+* server_set_nonblocking sets O_NONBLOCK on the descriptor
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fd is the descriptor
+* @return the status
+*/
+STATUS server_set_nonblocking(int fd)
+{
+  int flags = 0;
+
+  if ((flags = fcntl(fd, F_GETFL, 0)) == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+    return ERROR;
+
+  return OK;
+}
+
+/**
+* @brief Gets the time of a monotonic clock
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @return the time, in milliseconds
+*/
+long server_now_ms()
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+* @brief Gets the time since a moment
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param start is the moment, from the monotonic clock
+* @return the time since then, in milliseconds
+*/
+double server_ms_since(const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+* @brief Counts something done and the time it took
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param latency is the metric
+* @param ms is the time it took, in milliseconds
+*/
+void server_add_latency(Server_latency *latency, double ms)
+{
+  latency->count++;
+  latency->total_ms += ms;
+  if (ms > latency->max_ms)
+    latency->max_ms = ms;
+}
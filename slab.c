@@ -0,0 +1,189 @@
+/**
+ * @brief It implements an allocator of blocks of a single size
+ *
+ * The blocks are carved out of pages of many blocks, and a freed
+ * block goes to a list of free blocks that the next allocation takes
+ * first. As every block has the same size, a free block always fits
+ * the next allocation and the pages never fragment. Pages are only
+ * given back when the slab is destroyed.
+ *
+ * A slab is not locked, it belongs to a single thread.
+ *
+ * @file slab.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "slab.h"
+
+#define SLAB_ALIGN 16 /* Every block starts at a multiple of it */
+
+/**
+ * @brief A page of blocks
+ *
+ * The blocks follow the header, which is padded to keep them aligned
+ */
+typedef struct _Slab_page
+{
+  struct _Slab_page *next; /*!< The page taken before */
+  char pad[SLAB_ALIGN - sizeof(struct _Slab_page *)];
+} Slab_page;
+
+/**
+ * @brief A free block, its first bytes link it to the next one
+ */
+typedef struct _Slab_free
+{
+  struct _Slab_free *next; /*!< The next free block */
+} Slab_free;
+
+/**
+ * @brief The structure of the slab
+ */
+struct _Slab
+{
+  size_t size;        /*!< Bytes of a block */
+  int per_page;       /*!< Blocks in a page */
+  Slab_page *pages;   /*!< Pages taken, the newest first */
+  Slab_free *free;    /*!< Blocks freed or not used yet */
+  Slab_stats stats;   /*!< Its metrics */
+};
+
+/**
+* @brief Computes the creation of the slab
+*
+* slab_create creates a slab without pages, the first one is taken
+* with the first allocation
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param size is the size of the blocks
+* @param per_page is the number of blocks taken from malloc at once
+* @return the new slab or NULL if there is no memory
+*/
+Slab *slab_create(size_t size, int per_page)
+{
+  Slab *slab = NULL;
+
+  if (size == 0 || per_page < 1 || !(slab = (Slab *)calloc(1, sizeof(Slab))))
+    return NULL;
+
+  if (size < sizeof(Slab_free))
+    size = sizeof(Slab_free);
+  slab->size = (size + SLAB_ALIGN - 1) / SLAB_ALIGN * SLAB_ALIGN;
+  slab->per_page = per_page;
+  slab->stats.block_size = slab->size;
+
+  return slab;
+}
+
+/**
+* @brief Computes the destruction of the slab
+*
+* slab_destroy frees all the pages, with the blocks still in use
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param slab is the slab
+*/
+void slab_destroy(Slab *slab)
+{
+  Slab_page *page = NULL;
+
+  if (!slab)
+    return;
+
+  while ((page = slab->pages))
+  {
+    slab->pages = page->next;
+    free(page);
+  }
+  free(slab);
+}
+
+/**
+* @brief Allocates a block
+*
+* slab_alloc takes the last block freed, or a new page of blocks
+* when there is none
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param slab is the slab
+* @return the block, filled with zeros, or NULL if there is no memory
+*/
+void *slab_alloc(Slab *slab)
+{
+  Slab_page *page = NULL;
+  Slab_free *block = NULL;
+  char *blocks = NULL;
+  int i = 0;
+
+  if (!slab->free)
+  {
+    if (!(page = (Slab_page *)malloc(sizeof(Slab_page) + slab->size * slab->per_page)))
+      return NULL;
+    page->next = slab->pages;
+    slab->pages = page;
+
+    /* The blocks are linked backwards, so the first one is taken first */
+    blocks = (char *)(page + 1);
+    for (i = slab->per_page - 1; i >= 0; i--)
+    {
+      block = (Slab_free *)(blocks + slab->size * i);
+      block->next = slab->free;
+      slab->free = block;
+    }
+    slab->stats.pages++;
+    slab->stats.blocks += slab->per_page;
+  }
+
+  block = slab->free;
+  slab->free = block->next;
+  if (++slab->stats.in_use > slab->stats.peak)
+    slab->stats.peak = slab->stats.in_use;
+
+  memset(block, 0, slab->size);
+  return block;
+}
+
+/**
+* @brief Frees a block
+*
+* slab_free keeps the block for the next allocation
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param slab is the slab
+* @param block is a block allocated from the slab, or NULL
+*/
+void slab_free(Slab *slab, void *block)
+{
+  if (!block)
+    return;
+
+  ((Slab_free *)block)->next = slab->free;
+  slab->free = (Slab_free *)block;
+  slab->stats.in_use--;
+}
+
+/**
+* @brief Gets the metrics of the slab
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param slab is the slab
+* @param stats is where the metrics are copied
+*/
+void slab_get_stats(Slab *slab, Slab_stats *stats)
+{
+  *stats = slab->stats;
+}
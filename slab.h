@@ -0,0 +1,36 @@
+/**
+ * @brief It defines an allocator of blocks of a single size
+ *
+ * @file slab.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stddef.h>
+#include "types.h"
+
+typedef struct _Slab Slab;
+
+/**
+ * @brief The metrics of a slab
+ */
+typedef struct _Slab_stats
+{
+  size_t block_size;    /*!< Bytes of a block, rounded up */
+  unsigned long in_use; /*!< Blocks allocated */
+  unsigned long peak;   /*!< Most blocks allocated at once */
+  unsigned long blocks; /*!< Blocks in all the pages, used or free */
+  unsigned long pages;  /*!< Pages taken from malloc */
+} Slab_stats;
+
+Slab *slab_create(size_t size, int per_page);
+void slab_destroy(Slab *slab);
+void *slab_alloc(Slab *slab);
+void slab_free(Slab *slab, void *block);
+void slab_get_stats(Slab *slab, Slab_stats *stats);
+
+#endif
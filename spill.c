@@ -0,0 +1,271 @@
+/**
+ * @brief It implements a file where records are put aside
+ *
+ * The file is split in slots of the largest record, and a record is
+ * written in any free slot with its length before it, so only its own
+ * bytes are written and the rest of the slot is left as a hole. The
+ * slots freed are used again before the file grows.
+ *
+ * The file is removed as soon as it is created, so nothing is left
+ * behind when the process ends, however it ends. A spill file is not
+ * locked, it belongs to a single thread.
+ *
+ * @file spill.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "spill.h"
+
+#define SPILL_TEMPLATE "/tmp/oca-spill-XXXXXX" /* When no path is given */
+#define SPILL_HEADER 4                          /* Length of the record, little endian */
+#define SPILL_FREE_SIZE 64                      /* First capacity of the free slots */
+
+/**
+ * @brief The structure of the spill file
+ */
+struct _Spill
+{
+  int fd;             /*!< The file, already removed */
+  size_t slot_size;   /*!< Bytes of a slot, header included */
+  long *free;         /*!< Stack of the free slots */
+  long n_free;        /*!< Number of free slots */
+  long capacity;      /*!< Room in the stack */
+  Spill_stats stats;  /*!< Its metrics */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+STATUS spill_pwrite(int fd, const unsigned char *buf, size_t len, off_t at);
+
+/**
+* @brief Computes the creation of the spill file
+*
+* spill_create creates the file and removes its name at once
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param path is the file, or NULL for a new one in /tmp
+* @param record_size is the size of the largest record
+* @return the new spill file or NULL if it could not be created
+*/
+Spill *spill_create(const char *path, size_t record_size)
+{
+  Spill *spill = NULL;
+  char name[] = SPILL_TEMPLATE;
+
+  if (record_size == 0 || !(spill = (Spill *)calloc(1, sizeof(Spill))))
+    return NULL;
+
+  spill->fd = path ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0600) : mkstemp(name);
+  if (spill->fd == -1)
+  {
+    free(spill);
+    return NULL;
+  }
+  unlink(path ? path : name);
+  spill->slot_size = SPILL_HEADER + record_size;
+
+  return spill;
+}
+
+/**
+* @brief Computes the destruction of the spill file
+*
+* spill_destroy closes the file, which frees its space on the disk
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param spill is the spill file
+*/
+void spill_destroy(Spill *spill)
+{
+  if (!spill)
+    return;
+
+  close(spill->fd);
+  free(spill->free);
+  free(spill);
+}
+
+/**
+* @brief Puts a record aside
+*
+* spill_put writes the record in the last slot freed, or at the end
+* of the file when there is none
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param spill is the spill file
+* @param buf is the record
+* @param len is the number of bytes of the record
+* @return the slot of the record, or -1 if it could not be written
+*/
+long spill_put(Spill *spill, const void *buf, size_t len)
+{
+  unsigned char header[SPILL_HEADER];
+  long slot = 0;
+  int i = 0;
+
+  if (SPILL_HEADER + len > spill->slot_size)
+    return -1;
+
+  slot = spill->n_free > 0 ? spill->free[spill->n_free - 1] : (long)spill->stats.slots;
+  for (i = 0; i < SPILL_HEADER; i++)
+    header[i] = (unsigned char)(len >> (8 * i));
+
+  if (spill_pwrite(spill->fd, header, SPILL_HEADER, (off_t)slot * spill->slot_size) == ERROR ||
+      spill_pwrite(spill->fd, (const unsigned char *)buf, len, (off_t)slot * spill->slot_size + SPILL_HEADER) == ERROR)
+    return -1;
+
+  if (spill->n_free > 0)
+    spill->n_free--;
+  else
+    spill->stats.slots++;
+  spill->stats.records++;
+  spill->stats.written += SPILL_HEADER + len;
+
+  return slot;
+}
+
+/**
+* @brief Takes a record back
+*
+* spill_take reads the record of a slot and frees the slot. The slot
+* is freed even if the record can not be read
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param spill is the spill file
+* @param slot is the slot of the record
+* @param buf is where the record is read
+* @param size is the size of the buffer
+* @return the number of bytes of the record, or -1 if it could not be read
+*/
+long spill_take(Spill *spill, long slot, void *buf, size_t size)
+{
+  unsigned char header[SPILL_HEADER];
+  size_t len = 0, done = 0;
+  ssize_t n = 0;
+  off_t at = (off_t)slot * spill->slot_size;
+  int i = 0;
+
+  while ((n = pread(spill->fd, header, SPILL_HEADER, at)) == -1 && errno == EINTR)
+    ;
+  if (n == SPILL_HEADER)
+  {
+    for (i = 0; i < SPILL_HEADER; i++)
+      len |= (size_t)header[i] << (8 * i);
+    while (len <= size && done < len)
+    {
+      if ((n = pread(spill->fd, (char *)buf + done, len - done, at + SPILL_HEADER + done)) <= 0)
+      {
+        if (n == -1 && errno == EINTR)
+          continue;
+        break;
+      }
+      done += n;
+    }
+  }
+  spill_drop(spill, slot);
+
+  if (n < 0 || len > size || done < len)
+    return -1;
+
+  spill->stats.read += SPILL_HEADER + len;
+  return (long)len;
+}
+
+/**
+* @brief Frees the slot of a record not needed any more
+*
+* spill_drop does nothing if the slot is negative
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param spill is the spill file
+* @param slot is the slot of the record
+*/
+void spill_drop(Spill *spill, long slot)
+{
+  long *free_slots = NULL;
+
+  if (slot < 0)
+    return;
+
+  /* Without room to remember it the slot is lost, which only wastes disk */
+  if (spill->n_free == spill->capacity)
+  {
+    if (!(free_slots = (long *)realloc(spill->free, sizeof(long) * (spill->capacity ? spill->capacity * 2 : SPILL_FREE_SIZE))))
+    {
+      spill->stats.records--;
+      return;
+    }
+    spill->free = free_slots;
+    spill->capacity = spill->capacity ? spill->capacity * 2 : SPILL_FREE_SIZE;
+  }
+
+  spill->free[spill->n_free++] = slot;
+  spill->stats.records--;
+}
+
+/**
+* @brief Gets the metrics of the spill file
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param spill is the spill file
+* @param stats is where the metrics are copied
+*/
+void spill_get_stats(Spill *spill, Spill_stats *stats)
+{
+  *stats = spill->stats;
+}
+
+/**
+* @brief Writes all the bytes at a place of the file
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param fd is the file
+* @param buf is the bytes
+* @param len is the number of bytes
+* @param at is the offset in the file
+* @return the status
+*/
+STATUS spill_pwrite(int fd, const unsigned char *buf, size_t len, off_t at)
+{
+  ssize_t n = 0;
+
+  while (len > 0)
+  {
+    if ((n = pwrite(fd, buf, len, at)) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      return ERROR;
+    }
+    buf += n;
+    len -= n;
+    at += n;
+  }
+
+  return OK;
+}
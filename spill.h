@@ -0,0 +1,36 @@
+/**
+ * @brief It defines a file where records are put aside
+ *
+ * @file spill.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef SPILL_H
+#define SPILL_H
+
+#include <stddef.h>
+#include "types.h"
+
+typedef struct _Spill Spill;
+
+/**
+ * @brief The metrics of a spill file
+ */
+typedef struct _Spill_stats
+{
+  unsigned long records; /*!< Records in the file */
+  unsigned long slots;   /*!< Slots the file has grown to, used or free */
+  unsigned long written; /*!< Bytes written */
+  unsigned long read;    /*!< Bytes read */
+} Spill_stats;
+
+Spill *spill_create(const char *path, size_t record_size);
+void spill_destroy(Spill *spill);
+long spill_put(Spill *spill, const void *buf, size_t len);
+long spill_take(Spill *spill, long slot, void *buf, size_t size);
+void spill_drop(Spill *spill, long slot);
+void spill_get_stats(Spill *spill, Spill_stats *stats);
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @brief It implements a lock-free single producer single consumer
+ * queue of commands
+ *
+ * Only the producer writes the tail and only the consumer writes the
+ * head, so publishing each index with release semantics and reading
+ * the other one with acquire semantics is enough to share the slots.
+ *
+ * @file spsc_queue.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdlib.h>
+#include "spsc_queue.h"
+
+/**
+ * @brief The structure of the queue
+ *
+ * It stores the slots and the indexes of both ends, each one
+ * in its own cache line so the threads do not share it
+ */
+struct _Spsc_queue
+{
+  unsigned long head;                  /*!< Next slot to pop, written by the consumer */
+  char pad_head[64 - sizeof(unsigned long)];
+  unsigned long tail;                  /*!< Next slot to push, written by the producer */
+  char pad_tail[64 - sizeof(unsigned long)];
+  Command slots[SPSC_QUEUE_SIZE];      /*!< Queued commands */
+};
+
+/**
+* @brief Computes the creation of the queue
+*
+* spsc_queue_create creates an empty queue
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @return the new queue or NULL if there is no memory
+*/
+Spsc_queue *spsc_queue_create()
+{
+  return (Spsc_queue *)calloc(1, sizeof(Spsc_queue));
+}
+
+/**
+* @brief Computes the destruction of the queue
+*
+* spsc_queue_destroy frees the queue
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param queue is the queue which is going to be destroyed
+*/
+void spsc_queue_destroy(Spsc_queue *queue)
+{
+  free(queue);
+}
+
+/**
+* @brief Adds a command to the queue
+*
+* spsc_queue_push is only called from the producer thread
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param queue is the queue
+* @param command is the command
+* @return ERROR if the queue is full
+*/
+STATUS spsc_queue_push(Spsc_queue *queue, const Command *command)
+{
+  unsigned long tail = 0;
+
+  if (!queue || !command)
+    return ERROR;
+
+  tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+  if (tail - __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) >= SPSC_QUEUE_SIZE)
+    return ERROR;
+
+  queue->slots[tail % SPSC_QUEUE_SIZE] = *command;
+  __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+
+  return OK;
+}
+
+/**
+* @brief Takes a command from the queue
+*
+* spsc_queue_pop is only called from the consumer thread
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param queue is the queue
+* @param command is where the command is stored
+* @return ERROR if the queue is empty
+*/
+STATUS spsc_queue_pop(Spsc_queue *queue, Command *command)
+{
+  unsigned long head = 0;
+
+  if (!queue || !command)
+    return ERROR;
+
+  head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+  if (head == __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE))
+    return ERROR;
+
+  *command = queue->slots[head % SPSC_QUEUE_SIZE];
+  __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+  return OK;
+}
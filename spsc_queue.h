@@ -0,0 +1,26 @@
+/**
+ * @brief It defines a lock-free single producer single consumer
+ * queue of commands
+ *
+ * @file spsc_queue.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include "types.h"
+#include "command.h"
+
+#define SPSC_QUEUE_SIZE 1024
+
+typedef struct _Spsc_queue Spsc_queue;
+
+Spsc_queue *spsc_queue_create();
+void spsc_queue_destroy(Spsc_queue *queue);
+STATUS spsc_queue_push(Spsc_queue *queue, const Command *command);
+STATUS spsc_queue_pop(Spsc_queue *queue, Command *command);
+
+#endif
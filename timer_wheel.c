@@ -0,0 +1,381 @@
+/**
+ * @brief It implements a hierarchical wheel of timers
+ *
+ * The wheel has a few levels of slots, each level a coarser clock than
+ * the one below: a slot of the first level is a tick, and a slot of
+ * every other level spans a whole turn of the level below. A timer is
+ * put in the slot of the finest level that reaches its tick, so
+ * scheduling and cancelling it is just linking and unlinking it from
+ * the list of its slot, whatever the number of timers.
+ *
+ * Every time the clock of a level moves to a new slot, the timers of
+ * that slot move down to the finer levels, and the timers of the slot
+ * of the first level reached expire. A timer is moved at most once per
+ * level, so the cost of a timer does not depend on how many there are.
+ * Timers further away than the wheel reaches wait in its last slot and
+ * are placed again when they come down.
+ *
+ * The ticks are whatever the user counts, usually milliseconds of a
+ * monotonic clock. A wheel is not locked, it belongs to a single thread.
+ *
+ * @file timer_wheel.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdlib.h>
+#include "timer_wheel.h"
+
+#define WHEEL_BITS 6                        /* Bits of the clock of a level */
+#define WHEEL_SLOTS (1 << WHEEL_BITS)       /* Slots of a level */
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4                      /* Levels, so it reaches 2^24 ticks */
+#define WHEEL_SPAN (1UL << (WHEEL_BITS * WHEEL_LEVELS))
+
+/**
+ * @brief The structure of the wheel
+ *
+ * The slot heads are timers that are never scheduled, so every slot is
+ * a circular list and a timer leaves it without knowing the wheel
+ */
+struct _Timer_wheel
+{
+  Timer slots[WHEEL_LEVELS][WHEEL_SLOTS]; /*!< Heads of the lists of the slots */
+  unsigned long now;                      /*!< Last tick reached */
+  void *context;                          /*!< Passed to every callback */
+  Timer_wheel_stats stats;                /*!< Its metrics */
+};
+
+/****************************/
+/*     Private functions    */
+/****************************/
+void timer_wheel_place(Timer_wheel *wheel, Timer *timer);
+void timer_wheel_take(Timer *head, Timer *list);
+void timer_unlink(Timer *timer);
+
+/**
+* @brief Computes the creation of the wheel
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param now is the current tick
+* @param context is passed to the callbacks of the timers
+* @return the new wheel or NULL if there is no memory
+*/
+Timer_wheel *timer_wheel_create(unsigned long now, void *context)
+{
+  Timer_wheel *wheel = NULL;
+  int level = 0, slot = 0;
+
+  if (!(wheel = (Timer_wheel *)calloc(1, sizeof(Timer_wheel))))
+    return NULL;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    for (slot = 0; slot < WHEEL_SLOTS; slot++)
+      wheel->slots[level][slot].prev = wheel->slots[level][slot].next = &wheel->slots[level][slot];
+  wheel->now = now;
+  wheel->context = context;
+
+  return wheel;
+}
+
+/**
+* @brief Computes the destruction of the wheel
+*
+* timer_wheel_destroy frees the wheel. The timers still pending are
+* not touched, they have to be cancelled before
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+*/
+void timer_wheel_destroy(Timer_wheel *wheel)
+{
+  free(wheel);
+}
+
+/**
+* @brief Prepares a timer
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param timer is the timer
+* @param callback is called when it expires
+* @param data is passed to the callback
+*/
+void timer_init(Timer *timer, Timer_callback callback, void *data)
+{
+  timer->prev = timer->next = NULL;
+  timer->expires = 0;
+  timer->callback = callback;
+  timer->data = data;
+}
+
+/**
+* @brief Tells whether a timer is scheduled
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param timer is the timer
+* @return TRUE if it is scheduled and has not expired yet
+*/
+BOOL timer_is_pending(const Timer *timer)
+{
+  return timer->next ? TRUE : FALSE;
+}
+
+/**
+* @brief Schedules a timer
+*
+* timer_wheel_schedule makes the timer expire some ticks after the last
+* one reached, at least one. A timer already pending is moved
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+* @param timer is the timer
+* @param delay is the number of ticks until it expires
+*/
+void timer_wheel_schedule(Timer_wheel *wheel, Timer *timer, unsigned long delay)
+{
+  if (timer->next)
+    timer_unlink(timer);
+  else
+    wheel->stats.pending++;
+
+  timer->expires = wheel->now + (delay ? delay : 1);
+  timer_wheel_place(wheel, timer);
+}
+
+/**
+* @brief Cancels a timer
+*
+* timer_wheel_cancel does nothing if the timer is not pending
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+* @param timer is the timer
+*/
+void timer_wheel_cancel(Timer_wheel *wheel, Timer *timer)
+{
+  if (!timer->next)
+    return;
+
+  timer_unlink(timer);
+  wheel->stats.pending--;
+  wheel->stats.cancelled++;
+}
+
+/**
+* @brief Moves the wheel to a tick
+*
+* timer_wheel_advance goes over every tick up to the one given, moving
+* the timers down the levels and calling the ones that expire, in the
+* order of their ticks. A callback may schedule or cancel any timer
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+* @param now is the current tick
+* @return the number of timers expired
+*/
+unsigned long timer_wheel_advance(Timer_wheel *wheel, unsigned long now)
+{
+  Timer expired, *timer = NULL;
+  unsigned long fired = 0;
+  int level = 0;
+
+  while (wheel->now < now)
+  {
+    /* Nothing can expire on the way */
+    if (!wheel->stats.pending)
+    {
+      wheel->now = now;
+      break;
+    }
+    wheel->now++;
+
+    /* The levels whose clock moves to a new slot, the coarsest first */
+    for (level = 1; level < WHEEL_LEVELS && !(wheel->now & ((1UL << (WHEEL_BITS * level)) - 1)); level++)
+      ;
+    for (level--; level > 0; level--)
+    {
+      timer_wheel_take(&wheel->slots[level][(wheel->now >> (WHEEL_BITS * level)) & WHEEL_MASK], &expired);
+      while ((timer = expired.next) != &expired)
+      {
+        timer_unlink(timer);
+        timer_wheel_place(wheel, timer);
+        wheel->stats.cascaded++;
+      }
+    }
+
+    timer_wheel_take(&wheel->slots[0][wheel->now & WHEEL_MASK], &expired);
+    while ((timer = expired.next) != &expired)
+    {
+      timer_unlink(timer);
+      wheel->stats.pending--;
+      wheel->stats.fired++;
+      fired++;
+      timer->callback(wheel->context, timer->data);
+    }
+  }
+
+  return fired;
+}
+
+/**
+* @brief Gets the time until the wheel has to be advanced
+*
+* timer_wheel_next gives the ticks until the first timer expires, or
+* until timers of a coarser level have to move down, which is never
+* later
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+* @return the number of ticks, or -1 if there is no timer pending
+*/
+long timer_wheel_next(Timer_wheel *wheel)
+{
+  Timer *head = NULL;
+  unsigned long clock = 0, next = 0, best = 0;
+  int level = 0, k = 0;
+
+  if (!wheel->stats.pending)
+    return -1;
+
+  best = WHEEL_SPAN;
+  for (level = 0; level < WHEEL_LEVELS; level++)
+  {
+    clock = wheel->now >> (WHEEL_BITS * level);
+    for (k = 1; k <= WHEEL_SLOTS; k++)
+    {
+      head = &wheel->slots[level][(clock + k) & WHEEL_MASK];
+      if (head->next == head)
+        continue;
+      next = ((clock + k) << (WHEEL_BITS * level)) - wheel->now;
+      if (next < best)
+        best = next;
+      break;
+    }
+  }
+
+  return (long)best;
+}
+
+/**
+* @brief Gets the time of the wheel
+*
+* timer_wheel_get_now gives the last tick the wheel was advanced to,
+* which the delays of the timers scheduled count from
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+* @return the tick
+*/
+unsigned long timer_wheel_get_now(Timer_wheel *wheel)
+{
+  return wheel->now;
+}
+
+/**
+* @brief Gets the metrics of the wheel
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+* @param stats is where the metrics are copied
+*/
+void timer_wheel_get_stats(Timer_wheel *wheel, Timer_wheel_stats *stats)
+{
+  *stats = wheel->stats;
+}
+
+/**
+* @brief Puts a timer in its slot
+*
+* timer_wheel_place links the timer to the slot of the finest level
+* that reaches its tick
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param wheel is the wheel
+* @param timer is the timer, not linked anywhere
+*/
+void timer_wheel_place(Timer_wheel *wheel, Timer *timer)
+{
+  Timer *head = NULL;
+  unsigned long when = timer->expires, delta = timer->expires - wheel->now;
+  int level = 0;
+
+  /* Too far, it waits in the last slot the wheel reaches */
+  if (delta >= WHEEL_SPAN)
+  {
+    when = wheel->now + WHEEL_SPAN - 1;
+    delta = WHEEL_SPAN - 1;
+  }
+  while (level < WHEEL_LEVELS - 1 && delta >= 1UL << (WHEEL_BITS * (level + 1)))
+    level++;
+
+  head = &wheel->slots[level][(when >> (WHEEL_BITS * level)) & WHEEL_MASK];
+  timer->next = head;
+  timer->prev = head->prev;
+  head->prev->next = timer;
+  head->prev = timer;
+}
+
+/**
+* @brief Takes all the timers of a slot
+*
+* timer_wheel_take moves the list of the slot to another head, and
+* leaves the slot empty
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param head is the head of the slot
+* @param list is the head where the timers are moved
+*/
+void timer_wheel_take(Timer *head, Timer *list)
+{
+  if (head->next == head)
+  {
+    list->prev = list->next = list;
+    return;
+  }
+
+  list->next = head->next;
+  list->prev = head->prev;
+  list->next->prev = list;
+  list->prev->next = list;
+  head->prev = head->next = head;
+}
+
+/**
+* @brief Takes a timer out of its list
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param timer is the timer
+*/
+void timer_unlink(Timer *timer)
+{
+  timer->prev->next = timer->next;
+  timer->next->prev = timer->prev;
+  timer->prev = timer->next = NULL;
+}
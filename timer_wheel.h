@@ -0,0 +1,61 @@
+/**
+ * @brief It defines a hierarchical wheel of timers
+ *
+ * @file timer_wheel.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "types.h"
+
+typedef struct _Timer_wheel Timer_wheel;
+
+/**
+ * @brief What is called when a timer expires
+ *
+ * The context is the one of the wheel and the data the one of the
+ * timer. The timer is no longer pending, so it can be scheduled again
+ */
+typedef void (*Timer_callback)(void *context, void *data);
+
+/**
+ * @brief A timer
+ *
+ * It is kept by whoever uses it, usually inside its own structure, so
+ * scheduling it allocates nothing
+ */
+typedef struct _Timer
+{
+  struct _Timer *prev, *next; /*!< Neighbours in its slot, NULL if it is not pending */
+  unsigned long expires;      /*!< Tick when it expires */
+  Timer_callback callback;    /*!< Called when it expires */
+  void *data;                 /*!< Passed to the callback */
+} Timer;
+
+/**
+ * @brief The metrics of a wheel
+ */
+typedef struct _Timer_wheel_stats
+{
+  unsigned long pending;   /*!< Timers scheduled */
+  unsigned long fired;     /*!< Timers expired */
+  unsigned long cancelled; /*!< Timers cancelled before expiring */
+  unsigned long cascaded;  /*!< Times a timer moved to a finer level */
+} Timer_wheel_stats;
+
+Timer_wheel *timer_wheel_create(unsigned long now, void *context);
+void timer_wheel_destroy(Timer_wheel *wheel);
+void timer_init(Timer *timer, Timer_callback callback, void *data);
+BOOL timer_is_pending(const Timer *timer);
+void timer_wheel_schedule(Timer_wheel *wheel, Timer *timer, unsigned long delay);
+void timer_wheel_cancel(Timer_wheel *wheel, Timer *timer);
+unsigned long timer_wheel_advance(Timer_wheel *wheel, unsigned long now);
+long timer_wheel_next(Timer_wheel *wheel);
+unsigned long timer_wheel_get_now(Timer_wheel *wheel);
+void timer_wheel_get_stats(Timer_wheel *wheel, Timer_wheel_stats *stats);
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @brief It implements the board, shared by the games played on it
+ *
+ * The spaces, their links and names and the layout of the map never
+ * change while playing, so they are loaded once and every game keeps
+ * a reference to them, with only the positions of its own. The world
+ * is freed when the last game that uses it is destroyed. Nothing in it
+ * changes after it is loaded, so games in different threads can read
+ * it at the same time.
+ *
+ * @file world.c
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "world.h"
+#include "game_reader.h"
+
+/**
+ * @brief The structure of the world
+ */
+struct _World
+{
+  Space *spaces[MAX_SPACES + 1];   /*!< The spaces, in the order of the file */
+  Space *index[WORLD_INDEX_SIZE];  /*!< The spaces hashed by their id */
+  int n_spaces;                    /*!< Number of spaces */
+  Map_grid *grid;                  /*!< Layout of the spaces in the map */
+  int references;                  /*!< Games using it, updated atomically */
+};
+
+/**
+* @brief Computes the creation of the world
+*
+* world_create creates a world without spaces, with a single reference
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @return the new world or NULL if there is no memory
+*/
+World *world_create()
+{
+  World *world = NULL;
+
+  if (!(world = (World *)calloc(1, sizeof(World))))
+    return NULL;
+
+  world->references = 1;
+  return world;
+}
+
+/**
+* @brief Computes the creation of the world from a file
+*
+* world_create_from_file loads the spaces of a file and lays out
+* the map, which only depends on the links
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param filename is the file of the world
+* @return the new world or NULL if it could not be loaded
+*/
+World *world_create_from_file(char *filename)
+{
+  World *world = NULL;
+
+  if (!(world = world_create()))
+    return NULL;
+
+  if (game_reader_load_spaces(world, filename) == ERROR ||
+      !(world->grid = map_grid_create_layout(world->spaces, world->n_spaces)))
+  {
+    world_release(world);
+    return NULL;
+  }
+
+  return world;
+}
+
+/**
+* @brief Takes a reference to the world
+*
+* world_retain is called by every game that uses the world
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+* @return the world
+*/
+World *world_retain(World *world)
+{
+  if (world)
+    __atomic_add_fetch(&world->references, 1, __ATOMIC_RELAXED);
+
+  return world;
+}
+
+/**
+* @brief Leaves a reference to the world
+*
+* world_release frees the world when it was the last reference
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+*/
+void world_release(World *world)
+{
+  int i = 0;
+
+  if (!world || __atomic_sub_fetch(&world->references, 1, __ATOMIC_ACQ_REL) > 0)
+    return;
+
+  for (i = 0; i < world->n_spaces; i++)
+    space_destroy(world->spaces[i]);
+  map_grid_destroy(world->grid);
+  free(world);
+}
+
+/**
+* @brief Computes the creation of a new space
+*
+* world_add_space adds a new space, and adds it to the index
+* of the spaces by id. It is only used while the world is loaded
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+* @param space is the space
+* @return the status
+*/
+STATUS world_add_space(World *world, Space *space)
+{
+  unsigned long slot = 0;
+
+  if (!world || !space || world->n_spaces >= MAX_SPACES)
+    return ERROR;
+
+  world->spaces[world->n_spaces++] = space;
+
+  /* Linear probing, the index is never more than half full */
+  slot = (unsigned long)space_get_id(space) & (WORLD_INDEX_SIZE - 1);
+  while (world->index[slot] != NULL && space_get_id(world->index[slot]) != space_get_id(space))
+    slot = (slot + 1) & (WORLD_INDEX_SIZE - 1);
+  if (world->index[slot] == NULL)
+    world->index[slot] = space;
+
+  return OK;
+}
+
+/**
+* @brief Gets a space by its id
+*
+* world_get_space looks the id up in the index
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+* @param id is the id of the space
+* @return the space or NULL if there is none with that id
+*/
+Space *world_get_space(World *world, Id id)
+{
+  unsigned long slot = 0;
+
+  if (!world || id == NO_ID)
+    return NULL;
+
+  slot = (unsigned long)id & (WORLD_INDEX_SIZE - 1);
+  while (world->index[slot] != NULL)
+  {
+    if (id == space_get_id(world->index[slot]))
+      return world->index[slot];
+    slot = (slot + 1) & (WORLD_INDEX_SIZE - 1);
+  }
+
+  return NULL;
+}
+
+/**
+* @brief Gets a space by its position
+*
+* world_get_space_at gets the space in a position of the file
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+* @param position is the position, from 0
+* @return the space or NULL if there is none there
+*/
+Space *world_get_space_at(World *world, int position)
+{
+  if (!world || position < 0 || position >= world->n_spaces)
+    return NULL;
+
+  return world->spaces[position];
+}
+
+/**
+* @brief Gets the number of spaces
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+* @return the number of spaces
+*/
+int world_get_n_spaces(World *world)
+{
+  if (!world)
+    return 0;
+
+  return world->n_spaces;
+}
+
+/**
+* @brief Gets the layout of the map
+*
+* @date 19/10/2026
+* @author David Ramirez
+*
+* @param world is the world
+* @return the grid of the spaces
+*/
+Map_grid *world_get_map_grid(World *world)
+{
+  if (!world)
+    return NULL;
+
+  return world->grid;
+}
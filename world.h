@@ -0,0 +1,31 @@
+/**
+ * @brief It defines the board, shared by the games played on it
+ *
+ * @file world.h
+ * @author David Ramirez
+ * @version 1.0
+ * @date 19/10/2026
+ */
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "types.h"
+#include "space.h"
+#include "map_grid.h"
+
+#define WORLD_INDEX_SIZE 256 /* Power of two, at least twice MAX_SPACES */
+
+typedef struct _World World;
+
+World *world_create();
+World *world_create_from_file(char *filename);
+World *world_retain(World *world);
+void world_release(World *world);
+STATUS world_add_space(World *world, Space *space);
+Space *world_get_space(World *world, Id id);
+Space *world_get_space_at(World *world, int position);
+int world_get_n_spaces(World *world);
+Map_grid *world_get_map_grid(World *world);
+
+#endif